@@ -64,17 +64,19 @@ bin/lists revision history | sed -n '/^<revision/,$p' >> "$mainfile.tmp"
 sed '1,/^<revision_history>$/d' "$mainfile" >> "$mainfile.tmp"
 mv "$mainfile.tmp" "$mainfile"
 
-# Update the stored copy of the previous TOC, to use next time we generate
-# the revision history.
+# Update the stored copy of the previous TOC, and the snapshot of the status
+# of each issue, to use next time we generate the revision history.
 cp mailing/lwg-toc.html meta-data/lwg-toc.old.html
+cp mailing/lwg-toc.txt meta-data/lwg-toc.old.txt
+git add --intent-to-add meta-data/lwg-toc.old.txt
 bin/lists
 
 # Review the diff and commit.
-git diff "$mainfile" meta-data/lwg-toc.old.html
-if ! git diff --quiet "$mainfile" meta-data/lwg-toc.old.html
+git diff "$mainfile" meta-data/lwg-toc.old.html meta-data/lwg-toc.old.txt
+if ! git diff --quiet "$mainfile" meta-data/lwg-toc.old.html meta-data/lwg-toc.old.txt
 then
   confirm
-  git commit -m "$newrev" "$mainfile" meta-data/lwg-toc.old.html
+  git commit -m "$newrev" "$mainfile" meta-data/lwg-toc.old.html meta-data/lwg-toc.old.txt
 fi
 
 echo "New lists for publication on open-std.org are in lwg${rev:1}.zip"
@@ -0,0 +1,58 @@
+//        Copyright the C++ Library Working Group
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// SPDX-License-Identifier: BSL-1.0
+
+#include "date.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// parse_date is constexpr, so check it at compile time.
+static_assert(lwg::parse_date("14 Feb 2024").date == 2024y/2/14);
+static_assert(lwg::parse_date(" 1 june 1998 ").date == 1998y/6/1);
+static_assert(lwg::parse_date("01 SEP 2001").date == 2001y/9/1);
+static_assert(lwg::parse_date("1 September 2001").date == 2001y/9/1);
+static_assert(lwg::parse_date("").error == lwg::date_error::bad_day);
+static_assert(lwg::parse_date("Feb 2024").error == lwg::date_error::bad_day);
+static_assert(lwg::parse_date("14 Fe 2024").error == lwg::date_error::bad_month);
+static_assert(lwg::parse_date("14 Sept 2024").error == lwg::date_error::bad_month);
+static_assert(lwg::parse_date("14 Feb").error == lwg::date_error::bad_year);
+static_assert(lwg::parse_date("14 Feb 2024 x").error == lwg::date_error::trailing_text);
+static_assert(lwg::parse_date("14 Feb 2024 x").pos == 12);
+static_assert(lwg::parse_date("30 Feb 2024").error == lwg::date_error::invalid_date);
+
+auto describe(lwg::date_error e) -> std::string_view {
+   switch (e) {
+      case lwg::date_error::none:          return "no error";
+      case lwg::date_error::bad_day:       return "expected day of the month";
+      case lwg::date_error::bad_month:     return "expected month name";
+      case lwg::date_error::bad_year:      return "expected year";
+      case lwg::date_error::trailing_text: return "unexpected text after year";
+      case lwg::date_error::invalid_date:  return "no such day";
+   }
+   return "unknown error";
+}
+
+} // close unnamed namespace
+
+auto lwg::parse_date_or_throw(std::string_view s) -> std::chrono::year_month_day {
+   auto const r = parse_date(s);
+   if (!r) {
+      std::string msg{"date format error: "};
+      msg += describe(r.error);
+      msg += " at position ";
+      msg += std::to_string(r.pos);
+      msg += " in \"";
+      msg += s;
+      msg += '"';
+      throw std::runtime_error{msg};
+   }
+   return r.date;
+}
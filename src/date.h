@@ -0,0 +1,136 @@
+#ifndef INCLUDE_LWG_DATE_H
+#define INCLUDE_LWG_DATE_H
+
+// standard headers
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+namespace lwg
+{
+
+// The reasons that a date can fail to parse.
+enum class date_error {
+   none,
+   bad_day,          // day of the month is missing or not a number
+   bad_month,        // month is missing or not an English month name
+   bad_year,         // year is missing or not a number
+   trailing_text,    // something other than whitespace after the year
+   invalid_date,     // e.g. 31 Feb 2024
+};
+
+struct date_parse_result {
+   std::chrono::year_month_day date{};
+   date_error                  error = date_error::none;
+   std::size_t                 pos = 0;   // offset of the error in the input
+
+   constexpr explicit operator bool() const noexcept { return error == date_error::none; }
+};
+
+namespace detail
+{
+constexpr bool is_space(char c) noexcept {
+   return c == ' ' or c == '\t' or c == '\n' or c == '\r' or c == '\f' or c == '\v';
+}
+
+constexpr bool is_digit(char c) noexcept {
+   return c >= '0' and c <= '9';
+}
+
+constexpr bool is_alpha(char c) noexcept {
+   return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z');
+}
+
+constexpr char to_lower(char c) noexcept {
+   return (c >= 'A' and c <= 'Z') ? char(c - 'A' + 'a') : c;
+}
+
+inline constexpr std::array<std::string_view, 12> month_names{
+   "january", "february", "march", "april", "may", "june",
+   "july", "august", "september", "october", "november", "december"
+};
+} // close namespace detail
+
+constexpr auto parse_date(std::string_view s) noexcept -> date_parse_result {
+   // Parse a date in the form used by the <date> element of an issue, e.g. "14 Feb 2024",
+   // which is the same as std::chrono::parse(" %d %b %Y") in the "C" locale.
+   // The month can be abbreviated to three letters or spelled out in full, in any case.
+   // Leading and trailing whitespace is ignored.
+   //
+   // This does not allocate memory or use the global locale, so it is much cheaper
+   // than std::chrono::parse, and can be used in constant expressions.
+   std::size_t i = 0;
+   auto skip_space = [&] {
+      while (i < s.size() and detail::is_space(s[i])) {
+         ++i;
+      }
+   };
+   auto number = [&](std::size_t max_digits) {
+      int n = 0;
+      std::size_t const first = i;
+      while (i < s.size() and i - first < max_digits and detail::is_digit(s[i])) {
+         n = n * 10 + (s[i++] - '0');
+      }
+      return i == first ? -1 : n;
+   };
+
+   skip_space();
+   std::size_t const day_pos = i;
+   int const d = number(2);
+   if (d < 0) {
+      return {{}, date_error::bad_day, day_pos};
+   }
+
+   skip_space();
+   std::size_t const month_pos = i;
+   std::size_t len = 0;
+   while (i + len < s.size() and detail::is_alpha(s[i + len])) {
+      ++len;
+   }
+   unsigned m = 0;
+   if (len >= 3) {
+      for (unsigned k = 0; k != detail::month_names.size() and m == 0; ++k) {
+         auto const name = detail::month_names[k];
+         if (len == 3 or len == name.size()) {
+            bool match = len <= name.size();
+            for (std::size_t j = 0; match and j != len; ++j) {
+               match = detail::to_lower(s[i + j]) == name[j];
+            }
+            if (match) {
+               m = k + 1;
+            }
+         }
+      }
+   }
+   if (m == 0) {
+      return {{}, date_error::bad_month, month_pos};
+   }
+   i += len;
+
+   skip_space();
+   std::size_t const year_pos = i;
+   int const y = number(4);
+   if (y < 0) {
+      return {{}, date_error::bad_year, year_pos};
+   }
+
+   skip_space();
+   if (i != s.size()) {
+      return {{}, date_error::trailing_text, i};
+   }
+
+   auto const date = std::chrono::year{y} / std::chrono::month{m} / std::chrono::day(static_cast<unsigned>(d));
+   if (!date.ok()) {
+      return {{}, date_error::invalid_date, day_pos};
+   }
+   return {date, date_error::none, 0};
+}
+
+auto parse_date_or_throw(std::string_view s) -> std::chrono::year_month_day;
+   // Parse a date as for 'parse_date', or throw 'runtime_error' with a message
+   // that describes the problem and where it is in 's'.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_DATE_H
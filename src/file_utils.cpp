@@ -0,0 +1,258 @@
+//        Copyright the C++ Library Working Group
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// SPDX-License-Identifier: BSL-1.0
+
+#include "file_utils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# define LWG_HAVE_MMAP 1
+#endif
+
+#if __has_include(<sys/uio.h>)
+# include <cerrno>
+# include <climits>
+# include <fcntl.h>
+# include <sys/uio.h>
+# include <unistd.h>
+# define LWG_HAVE_WRITEV 1
+#endif
+
+namespace fs = std::filesystem;
+
+auto lwg::read_file_into_string(fs::path const & filename) -> std::string {
+   std::ifstream infile{filename};
+   if (!infile.is_open()) {
+      throw std::runtime_error{"Unable to open file " + filename.string()};
+   }
+
+   // Read the whole file with a single call, instead of one character at a time.
+   // In text mode the file size is only an upper bound, so trim what was not read.
+   std::string s;
+   std::error_code ec;
+   if (auto size = fs::file_size(filename, ec); !ec) {
+      s.resize(size);
+      infile.read(s.data(), s.size());
+      s.resize(infile.gcount());
+   }
+
+   // If the size was not known (or the file grew) read whatever is left.
+   if (infile) {
+      s.append(std::istreambuf_iterator<char>{infile}, std::istreambuf_iterator<char>{});
+   }
+   return s;
+}
+
+auto lwg::issue_files(fs::path const & issues_path) -> std::vector<fs::path> {
+   auto is_issue_xml_file = [](fs::directory_entry const & e) {
+      if (e.is_regular_file()) {
+         auto f = e.path().filename().string();
+         return f.starts_with("issue") && f.ends_with(".xml");
+      }
+      return false;
+   };
+
+   std::vector<fs::path> files;
+   for (auto const & ent : fs::directory_iterator(issues_path)) {
+      if (is_issue_xml_file(ent)) {
+         files.push_back(ent.path());
+      }
+   }
+   std::ranges::sort(files);
+   return files;
+}
+
+auto lwg::hash_bytes(std::string_view s, std::uint64_t seed) -> std::uint64_t {
+   for (unsigned char c : s) {
+      seed ^= c;
+      seed *= 0x100000001b3ull;
+   }
+   return seed;
+}
+
+lwg::mapped_file::mapped_file(fs::path const & filename, [[maybe_unused]] bool may_change) {
+#ifdef LWG_HAVE_MMAP
+   if (!may_change) {
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0) {
+         throw std::runtime_error{"Unable to open file " + filename.string()};
+      }
+
+      struct ::stat st{};
+      bool const have_size = ::fstat(fd, &st) == 0;
+      if (have_size and st.st_size > 0) {
+         void * p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+         if (p != MAP_FAILED) {
+            m_data = static_cast<char const *>(p);
+            m_size = st.st_size;
+            m_mapped = true;
+         }
+      }
+      ::close(fd);
+
+      // Empty files cannot be mapped, but there is nothing to read either.
+      if (m_mapped or (have_size and st.st_size == 0)) {
+         return;
+      }
+   }
+#endif
+   // Mapping is not supported, not wanted, or failed, so read the file instead.
+   m_buffer = read_file_into_string(filename);
+   m_data = m_buffer.data();
+   m_size = m_buffer.size();
+}
+
+lwg::mapped_file::mapped_file(mapped_file && other) noexcept
+   : m_data{std::exchange(other.m_data, nullptr)}
+   , m_size{std::exchange(other.m_size, 0)}
+   , m_mapped{std::exchange(other.m_mapped, false)}
+   , m_buffer{std::move(other.m_buffer)}
+{
+   if (!m_mapped) {
+      m_data = m_buffer.data();
+   }
+}
+
+auto lwg::mapped_file::operator=(mapped_file && other) noexcept -> mapped_file & {
+   if (this != &other) {
+      unmap();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+      m_mapped = std::exchange(other.m_mapped, false);
+      m_buffer = std::move(other.m_buffer);
+      if (!m_mapped) {
+         m_data = m_buffer.data();
+      }
+   }
+   return *this;
+}
+
+lwg::mapped_file::~mapped_file() {
+   unmap();
+}
+
+void lwg::mapped_file::unmap() noexcept {
+#ifdef LWG_HAVE_MMAP
+   if (m_mapped) {
+      ::munmap(const_cast<char *>(m_data), m_size);
+   }
+#endif
+   m_mapped = false;
+}
+
+auto lwg::document_buffer::buffer::overflow(int_type c) -> int_type {
+   if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      text.push_back(traits_type::to_char_type(c));
+   }
+   return traits_type::not_eof(c);
+}
+
+auto lwg::document_buffer::buffer::xsputn(char const * s, std::streamsize n) -> std::streamsize {
+   text.append(s, n);
+   return n;
+}
+
+lwg::document_buffer::document_buffer()
+   : std::ostream{nullptr}
+{
+   rdbuf(&m_buffer);
+}
+
+void lwg::document_buffer::splice(std::string_view s) {
+   // Copying a short string is cheaper than writing it separately.
+   if (s.size() < 256) {
+      m_buffer.text += s;
+   }
+   else {
+      m_spliced.push_back({m_buffer.text.size(), s});
+   }
+}
+
+void lwg::document_buffer::splice(document_buffer const & other) {
+   std::string_view const text = other.m_buffer.text;
+   std::size_t copied = 0;
+   for (auto const & [offset, spliced] : other.m_spliced) {
+      m_buffer.text += text.substr(copied, offset - copied);
+      m_spliced.push_back({m_buffer.text.size(), spliced});
+      copied = offset;
+   }
+   m_buffer.text += text.substr(copied);
+}
+
+void lwg::document_buffer::write_to(fs::path const & filename) const {
+   // The pieces of the document in order, alternating between the buffer and the spliced text.
+   std::vector<std::string_view> pieces;
+   pieces.reserve(2 * m_spliced.size() + 1);
+   std::string_view const text = m_buffer.text;
+   std::size_t copied = 0;
+   for (auto const & [offset, spliced] : m_spliced) {
+      pieces.push_back(text.substr(copied, offset - copied));
+      pieces.push_back(spliced);
+      copied = offset;
+   }
+   pieces.push_back(text.substr(copied));
+
+#ifdef LWG_HAVE_WRITEV
+   int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+   if (fd < 0) {
+      throw std::runtime_error{"Failed to open " + filename.string()};
+   }
+
+   std::vector<::iovec> iov;
+   iov.reserve(pieces.size());
+   for (auto piece : pieces) {
+      if (!piece.empty()) {
+         iov.push_back({const_cast<char *>(piece.data()), piece.size()});
+      }
+   }
+
+   // writev may write less than was asked for, and takes at most IOV_MAX pieces at a time.
+   std::size_t next = 0;
+   while (next != iov.size()) {
+      int const count = static_cast<int>(std::min<std::size_t>(iov.size() - next, IOV_MAX));
+      ::ssize_t written = ::writev(fd, iov.data() + next, count);
+      if (written < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         ::close(fd);
+         throw std::runtime_error{"Failed to write " + filename.string()};
+      }
+      while (next != iov.size() and static_cast<std::size_t>(written) >= iov[next].iov_len) {
+         written -= iov[next].iov_len;
+         ++next;
+      }
+      if (written > 0) {
+         iov[next].iov_base = static_cast<char *>(iov[next].iov_base) + written;
+         iov[next].iov_len -= written;
+      }
+   }
+   if (::close(fd) != 0) {
+      throw std::runtime_error{"Failed to write " + filename.string()};
+   }
+#else
+   std::ofstream out{filename};
+   if (!out) {
+      throw std::runtime_error{"Failed to open " + filename.string()};
+   }
+   for (auto piece : pieces) {
+      out.write(piece.data(), piece.size());
+   }
+   if (!out.flush()) {
+      throw std::runtime_error{"Failed to write " + filename.string()};
+   }
+#endif
+}
@@ -0,0 +1,102 @@
+#ifndef INCLUDE_LWG_FILE_UTILS_H
+#define INCLUDE_LWG_FILE_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lwg
+{
+
+// Read a text file completely into memory, and return its contents as
+// a 'string' for further manipulation.
+auto read_file_into_string(std::filesystem::path const & filename) -> std::string;
+
+// Return the names of all the issue files (issueNNNN.xml) in the directory
+// 'issues_path', sorted by name.
+auto issue_files(std::filesystem::path const & issues_path) -> std::vector<std::filesystem::path>;
+
+// A 64-bit FNV-1a hash of 's', continuing from 'seed'.
+// This is not cryptographically secure, it is only used to detect changes.
+auto hash_bytes(std::string_view s, std::uint64_t seed = 0xcbf29ce484222325ull) -> std::uint64_t;
+
+// A read-only view of the contents of a file.
+// Where possible the file is mapped into memory, so that the contents are
+// never copied. Otherwise it is read into a buffer owned by this object.
+// The view returned by 'contents()' is valid until this object is destroyed.
+// A file that is truncated while it is mapped raises SIGBUS when the missing
+// part is read, so if another program may modify the file while it is being
+// used, e.g. an editor saving an issue in watch mode, pass 'may_change' to
+// always read it into the buffer.
+class mapped_file {
+public:
+   explicit mapped_file(std::filesystem::path const & filename, bool may_change = false);
+
+   mapped_file(mapped_file && other) noexcept;
+   mapped_file & operator=(mapped_file && other) noexcept;
+   ~mapped_file();
+
+   auto contents() const noexcept -> std::string_view { return {m_data, m_size}; }
+
+private:
+   void unmap() noexcept;
+
+   char const * m_data = nullptr;
+   std::size_t  m_size = 0;
+   bool         m_mapped = false;
+   std::string  m_buffer;   // used when the file cannot be mapped
+};
+
+// A document that is built in memory and then written to a file in one go.
+// Text written with 'operator<<' is copied into a buffer owned by this object,
+// but large strings that already exist can be added with 'splice', which only
+// keeps a reference to them, so they must outlive the call to 'write_to'.
+// Where possible the pieces are written with a single 'writev' system call,
+// so spliced strings are never copied at all.
+class document_buffer : public std::ostream {
+public:
+   document_buffer();
+
+   document_buffer(document_buffer const &) = delete;
+   document_buffer & operator=(document_buffer const &) = delete;
+
+   void splice(std::string_view s);
+      // Add 's' to the document at the current position, without copying it
+      // unless it is short.
+
+   void splice(document_buffer const & other);
+      // Add the contents of 'other' to the document at the current position.
+      // The strings spliced into 'other' are not copied either, so they must
+      // also outlive the call to 'write_to'.
+
+   void write_to(std::filesystem::path const & filename) const;
+      // Replace the contents of 'filename' with the document.
+      // Throws 'runtime_error' if the file cannot be opened or written.
+
+private:
+   class buffer : public std::streambuf {
+   public:
+      std::string text;
+
+   protected:
+      auto overflow(int_type c) -> int_type override;
+      auto xsputn(char const * s, std::streamsize n) -> std::streamsize override;
+   };
+
+   struct spliced_text {
+      std::size_t      offset;   // the position in 'm_buffer.text' where 'text' goes
+      std::string_view text;
+   };
+
+   buffer                    m_buffer;
+   std::vector<spliced_text> m_spliced;
+};
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_FILE_UTILS_H
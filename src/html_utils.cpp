@@ -6,7 +6,9 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "html_utils.h"
-#include <format>
+#include <algorithm>
+#include <cctype>
+#include <functional>
 
 namespace lwg
 {
@@ -24,22 +26,120 @@ find_element(std::string_view elem, std::string_view xml)
   if (elem.empty()) [[unlikely]]
     return xml.npos;
 
-  std::string start_tag = std::format("<{}", elem);
-  std::string_view::size_type pos = 0;
-  while ((pos = xml.find(start_tag, pos)) != xml.npos)
+  // Search for "elem" and check it is preceded by '<',
+  // instead of creating a "<elem" string to search for.
+  std::string_view::size_type pos = 1;
+  while ((pos = xml.find(elem, pos)) != xml.npos)
   {
-    if ((pos + start_tag.size()) == xml.size()) [[unlikely]]
+    if ((pos + elem.size()) == xml.size()) [[unlikely]]
       return xml.npos;
 
-    if (char c = xml[pos + start_tag.size()]; c == '>' or is_whitespace(c) or c == '/')
-      return pos;
-    pos += start_tag.size();
+    if (xml[pos - 1] == '<')
+      if (char c = xml[pos + elem.size()]; c == '>' or is_whitespace(c) or c == '/')
+        return pos - 1;
+    pos += elem.size();
   }
   return pos;
 }
 
-// FIXME: This cannot handle "<p> <p>nested</p> </p>",
-// it returns up to the first "</p>" instead of the second.
+// A piece of markup starting with '<', as found by scan_markup.
+struct markup
+{
+  enum kind_type { start_tag, end_tag, empty_elem_tag, other } kind;
+  std::string_view name;          // element name, empty unless a tag
+  std::string_view::size_type first, last; // xml[first, last) is the markup
+};
+
+// Scan the markup at xml[pos], which must be a '<' character.
+// Returns nullopt if the markup is not terminated.
+std::optional<markup>
+scan_markup(std::string_view xml, std::string_view::size_type pos)
+{
+  auto skip_to = [&](std::string_view end) -> std::optional<markup> {
+    auto e = xml.find(end, pos + 2);
+    if (e == xml.npos) [[unlikely]]
+      return std::nullopt;
+    return markup{markup::other, {}, pos, e + end.size()};
+  };
+
+  std::string_view rest = xml.substr(pos);
+  if (rest.starts_with("<!--"))
+    return skip_to("-->");
+  if (rest.starts_with("<![CDATA["))
+    return skip_to("]]>");
+  if (rest.starts_with("<?"))
+    return skip_to("?>");
+  if (rest.starts_with("<!")) // e.g. <!DOCTYPE ...>
+    return skip_to(">");
+
+  const bool closing = rest.starts_with("</");
+  auto name_start = pos + 1 + closing;
+  auto name_end = xml.find_first_of(" \t\n\r/>", name_start);
+  if (name_end == xml.npos) [[unlikely]]
+    return std::nullopt;
+  if (name_end == name_start) [[unlikely]] // not a tag, e.g. "a < b"
+    return markup{markup::other, {}, pos, pos + 1};
+
+  // Find the end of the tag, ignoring any '>' in quoted attribute values.
+  char quote = 0;
+  auto i = name_end;
+  for (; i != xml.size(); ++i)
+  {
+    char c = xml[i];
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '"' or c == '\'')
+      quote = c;
+    else if (c == '>')
+      break;
+  }
+  if (i == xml.size()) [[unlikely]]
+    return std::nullopt;
+
+  // EmptyElemTag ::= '<' Name (S Attribute)* S? '/>'
+  auto kind = closing ? markup::end_tag
+            : xml[i - 1] == '/' ? markup::empty_elem_tag
+            : markup::start_tag;
+  return markup{kind, xml.substr(name_start, name_end - name_start), pos, i + 1};
+}
+
+issue_tag
+scan_issue_tag(std::string_view text, std::string_view::size_type pos)
+{
+  // The character following the '<' has to start an opening or closing tag
+  // like <foo> or </foo>, or a comment like <!--.
+  auto malformed = [pos](const char* why) {
+    return issue_tag{issue_tag::malformed, {}, pos, pos, why};
+  };
+  if (pos + 1 == text.size())
+    return malformed("Unescaped '<'");
+  if (char c = text[pos + 1]; !std::isalpha(static_cast<unsigned char>(c)) and c != '/' and c != '!')
+    return malformed("Unescaped '<'");
+
+  auto const last = text.find('>', pos);
+  if (last == text.npos)
+    return malformed("Missing '>'");
+
+  // The element name is the first word after the '<'.
+  constexpr std::string_view space = " \t\n\v\f\r";
+  std::string_view name = text.substr(pos + 1, last - pos - 1);
+  name.remove_prefix(std::min(name.find_first_not_of(space), name.size()));
+  name = name.substr(0, name.find_first_of(space));
+  if (name.empty())
+    return malformed("Unexpected <>");
+
+  if (name[0] == '/')
+    return {issue_tag::end_tag, name.substr(1), pos, last};
+  if (text[last - 1] == '/')
+    return {issue_tag::empty_elem_tag, name, pos, last};
+  if (name == "!--")
+    return {issue_tag::comment, name, pos, std::min(text.find("-->", pos), text.size() - 3) + 2};
+  return {issue_tag::start_tag, name, pos, last};
+}
+
 std::optional<xml_element>
 get_element(std::string_view elem, std::string_view xml)
 {
@@ -50,24 +150,31 @@ get_element(std::string_view elem, std::string_view xml)
 
   xml.remove_prefix(pos); // Remove everything before "<elem"
 
-  pos = xml.find('>');
-  if (pos == xml.npos) [[unlikely]]
+  auto start = scan_markup(xml, 0);
+  if (!start) [[unlikely]]
     return std::nullopt;
 
   // Check for self-closing tag, e.g. "<p/>"
-  // EmptyElemTag ::= '<' Name (S Attribute)* S? '/>'
-  if (xml[pos - 1] == '/')
-    return xml_element{xml.substr(0, pos + 1), {}};
-
-  ++pos;
-  // N.B. we assume no whitespace in end tag, i.e. "</elem>" not "</elem >"
-  // although the XML spec does allow it: ETag ::= '</' Name S? '>'
-  std::string end_tag = std::format("</{}>", elem);
-  auto pos2 = xml.find(end_tag, pos);
-  if (pos2 == xml.npos) [[unlikely]]
-    return std::nullopt;
+  if (start->kind == markup::empty_elem_tag)
+    return xml_element{xml.substr(0, start->last), {}};
 
-  return xml_element{xml.substr(0, pos2 + end_tag.size()), xml.substr(pos, pos2 - pos)};
+  // Find the matching end tag, skipping any nested elements with the same name.
+  int depth = 1;
+  for (pos = xml.find('<', start->last); pos != xml.npos; pos = xml.find('<', pos))
+  {
+    auto m = scan_markup(xml, pos);
+    if (!m) [[unlikely]]
+      break;
+    pos = m->last;
+    if (m->name != elem)
+      continue;
+    if (m->kind == markup::start_tag)
+      ++depth;
+    else if (m->kind == markup::end_tag and --depth == 0)
+      return xml_element{xml.substr(0, m->last),
+                         xml.substr(start->last, m->first - start->last)};
+  }
+  return std::nullopt;
 }
 
 std::optional<std::string_view>
@@ -138,6 +245,107 @@ get_attribute_of(std::string_view attr, std::string_view elem, std::string_view
   return std::nullopt;
 }
 
+xml_index::xml_index(std::string_view xml)
+{
+  std::vector<std::uint32_t> open; // elements with no end tag yet
+
+  for (auto pos = xml.find('<'); pos != xml.npos; pos = xml.find('<', pos))
+  {
+    auto m = scan_markup(xml, pos);
+    if (!m) [[unlikely]]
+      break;
+    pos = m->last;
+
+    switch (m->kind)
+    {
+    case markup::start_tag:
+      open.push_back(nodes.size());
+      nodes.push_back({m->name, xml.substr(m->first, m->last - m->first), {}, false});
+      break;
+    case markup::empty_elem_tag:
+    {
+      auto tag = xml.substr(m->first, m->last - m->first);
+      nodes.push_back({m->name, tag, xml_element{tag, {}}, true});
+      break;
+    }
+    case markup::end_tag:
+      // Close the innermost open element with this name.
+      // Any elements opened inside it without being closed are abandoned.
+      for (auto k = open.size(); k != 0; --k)
+      {
+        node& n = nodes[open[k - 1]];
+        if (n.name == m->name)
+        {
+          auto first = n.start_tag.data() - xml.data();
+          auto inner = first + n.start_tag.size();
+          n.element = {xml.substr(first, m->last - first), xml.substr(inner, m->first - inner)};
+          n.complete = true;
+          open.resize(k - 1);
+          break;
+        }
+      }
+      break;
+    case markup::other:
+      break;
+    }
+  }
+
+  by_name.resize(nodes.size());
+  for (std::uint32_t i = 0; i != by_name.size(); ++i)
+    by_name[i] = i;
+  std::ranges::stable_sort(by_name, {}, [this](std::uint32_t i) { return nodes[i].name; });
+}
+
+std::span<const std::uint32_t>
+xml_index::find_nodes(std::string_view elem) const
+{
+  auto [first, last] = std::ranges::equal_range(by_name, elem, {},
+      [this](std::uint32_t i) { return nodes[i].name; });
+  return {first, last};
+}
+
+std::optional<xml_element>
+xml_index::get_element(std::string_view elem) const
+{
+  for (auto i : find_nodes(elem))
+    if (nodes[i].complete)
+      return nodes[i].element;
+  return std::nullopt;
+}
+
+std::optional<std::string_view>
+xml_index::get_element_content(std::string_view elem) const
+{
+  if (auto o = get_element(elem)) [[likely]]
+    return o->inner;
+  return std::nullopt;
+}
+
+std::optional<std::string_view>
+xml_index::get_attribute_of(std::string_view attr, std::string_view elem) const
+{
+  for (auto i : find_nodes(elem))
+    if (auto o = lwg::get_attribute(attr, nodes[i].start_tag))
+      return o;
+  return std::nullopt;
+}
+
+std::vector<xml_element>
+xml_index::get_elements(std::string_view elem, std::string_view range) const
+{
+  std::less<const char*> before;
+  std::vector<xml_element> elements;
+  for (auto i : find_nodes(elem))
+  {
+    const node& n = nodes[i];
+    if (n.complete
+        and not before(n.element.outer.data(), range.data())
+        and not before(range.data() + range.size(), n.element.outer.data() + n.element.outer.size()))
+      elements.push_back(n.element);
+  }
+  return elements;
+}
+
 } // namespace lwg
 
 #ifdef SELF_TEST
@@ -181,7 +389,7 @@ line = "ok"
   assert(lwg::get_element("elt", xml)->outer == "<elt attr=\"foo\" attr2=\"bar\" />");
   assert(lwg::get_element_content("elt", xml) == "");
   assert(lwg::get_element_content("p", xml) == "para <p/>another para");
-  // FIXME: assert(lwg::get_element_content("blockquote", xml) == "quote <blockquote>nested quote</blockquote>");
+  assert(lwg::get_element_content("blockquote", xml) == "quote <blockquote>nested quote</blockquote>");
   assert(lwg::get_attribute("attr", xml) == "foo");
   assert(lwg::get_attribute("attr3", xml) == "three");
   assert(lwg::get_attribute_of("attr3", "elt", xml) == "three");
@@ -201,5 +409,56 @@ line = "ok"
 
   assert(lwg::get_attribute_of("single", "quotes", xml) == "1");
   assert(lwg::get_attribute_of("double", "quotes", xml) == "2");
+
+  // The index should give the same answers as the functions above:
+  lwg::xml_index const index{xml};
+  assert(not index.get_element(""));
+  assert(not index.get_element_content("nonesuch"));
+  assert(not index.get_attribute_of("attr", "nonesuch"));
+  assert(index.get_element("elem")->outer == "<elem>content <x/> ...</elem>");
+  assert(index.get_element_content("elem") == "content <x/> ...");
+  assert(index.get_element("x")->outer == "<x/>");
+  assert(index.get_element_content("x") == "");
+  assert(index.get_element("elt")->outer == "<elt attr=\"foo\" attr2=\"bar\" />");
+  assert(index.get_element_content("p") == "para <p/>another para");
+  assert(index.get_element_content("blockquote") == "quote <blockquote>nested quote</blockquote>");
+  assert(index.get_attribute_of("attr3", "elt") == "three");
+  assert(index.get_attribute_of("attr", "el") == "baz");
+  assert(not index.get_attribute_of("attr2", "el"));
+  assert(index.get_attribute_of("lines", "new") == "also ok");
+  assert(index.get_attribute_of("attr", "elem_not_attr_still_not_attr") == "this");
+  assert(not index.get_attribute_of("not_really_an_attr", "text"));
+  assert(index.get_attribute_of("single", "quotes") == "1");
+
+  auto quotes = index.get_elements("blockquote", xml);
+  assert(quotes.size() == 2);
+  assert(quotes[1].inner == "nested quote");
+  assert(index.get_elements("blockquote", quotes[0].inner).size() == 1);
+  assert(index.get_elements("elt", *index.get_element_content("xml")).size() == 2);
+  assert(index.get_elements("elt", *index.get_element_content("elem")).empty());
+
+  // Markup that is not an element is skipped, and unclosed elements are not found:
+  lwg::xml_index const index2{"<?xml version='1.0'?><!-- <a>x</a> --><a title='>'><b>1<b>2</a>"};
+  assert(index2.get_element_content("a") == "<b>1<b>2");
+  assert(index2.get_attribute_of("title", "a") == ">");
+  assert(not index2.get_element("b"));
+
+  // Markup in the issue text:
+  std::string_view const text = "<p>x</p><sref ref=\"[a]\"/><!-- <p> --><! a < b <>< /x>";
+  auto t = lwg::scan_issue_tag(text, 0);
+  assert(t.kind == lwg::issue_tag::start_tag and t.name == "p" and t.last == 2);
+  t = lwg::scan_issue_tag(text, 4);
+  assert(t.kind == lwg::issue_tag::end_tag and t.name == "p" and t.last == 7);
+  t = lwg::scan_issue_tag(text, 8);
+  assert(t.kind == lwg::issue_tag::empty_elem_tag and t.name == "sref");
+  t = lwg::scan_issue_tag(text, t.last + 1);
+  assert(t.kind == lwg::issue_tag::comment and text.substr(t.last - 2, 3) == "-->");
+  t = lwg::scan_issue_tag(text, t.last + 1);
+  assert(t.kind == lwg::issue_tag::start_tag and t.name == "!");
+  assert(lwg::scan_issue_tag(text, text.find("< b")).kind == lwg::issue_tag::malformed);
+  assert(lwg::scan_issue_tag(text, text.find("<>")).kind == lwg::issue_tag::malformed);
+  assert(lwg::scan_issue_tag(text, text.find("< /")).kind == lwg::issue_tag::malformed);
+  assert(lwg::scan_issue_tag("<!-- <p>", 0).last == 7);
+  assert(lwg::scan_issue_tag("<p", 0).kind == lwg::issue_tag::malformed);
 }
 #endif
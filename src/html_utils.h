@@ -1,6 +1,12 @@
+#ifndef INCLUDE_LWG_HTML_UTILS_H
+#define INCLUDE_LWG_HTML_UTILS_H
+
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
-#include <optional>
+#include <vector>
 
 namespace lwg
 {
@@ -48,9 +54,76 @@ std::optional<std::string_view> get_attribute(std::string_view attr, std::string
 std::optional<std::string_view> get_attribute_of(std::string_view attr, std::string_view elem,
                                                  std::string_view xml);
 
+// A piece of markup in the text of an issue, as found by scan_issue_tag.
+struct issue_tag
+{
+  enum kind_type { start_tag, end_tag, empty_elem_tag, comment, malformed } kind;
+  std::string_view name;                   // element name, without the '/' of an end tag
+  std::string_view::size_type first, last; // text[first, last] is the markup, including the '>'
+  const char* error = nullptr;             // why the markup is malformed
+};
+
+// Scan the markup at text[pos], which must be a '<' character, the way the
+// issue text is formatted: the element name is the first word after the '<',
+// and a comment that is not closed extends to the end of the text.
+// Unlike the scanning used by xml_index, malformed markup is reported
+// instead of skipped, so that it can be fixed in the issue.
+// Everything that reads markup in the issue text should use this,
+// so that they all agree on where the tags are.
+[[nodiscard]]
+issue_tag scan_issue_tag(std::string_view text, std::string_view::size_type pos);
+
+// An index of the elements in an XML document, built by a single pass over it.
+// Each lookup is answered from the index without rescanning the document,
+// so use this instead of the functions above when querying several elements
+// of the same document. Unlike get_element, elements with the same name
+// can be nested, e.g. "<p> <p>nested</p> </p>" is found as a single element.
+// Comments, CDATA sections and processing instructions are skipped.
+// The index refers to the document, so the document must outlive it.
+class xml_index
+{
+public:
+  explicit xml_index(std::string_view xml);
+
+  // Find the first complete "<elem>...</elem>" in the document.
+  [[nodiscard]]
+  std::optional<xml_element> get_element(std::string_view elem) const;
+
+  // As above, but only return the inner part.
+  [[nodiscard]]
+  std::optional<std::string_view> get_element_content(std::string_view elem) const;
+
+  // Find the first <elem attr="..."> and return the attribute's value.
+  [[nodiscard]]
+  std::optional<std::string_view> get_attribute_of(std::string_view attr, std::string_view elem) const;
+
+  // Find every complete <elem> that is contained in 'range', in document order.
+  // 'range' must be a part of the indexed document, e.g. the inner part of
+  // another element.
+  [[nodiscard]]
+  std::vector<xml_element> get_elements(std::string_view elem, std::string_view range) const;
+
+private:
+  struct node
+  {
+    std::string_view name;      // "elem"
+    std::string_view start_tag; // "<elem attr='value'>"
+    xml_element element;        // set when the end tag is found
+    bool complete = false;
+  };
+
+  // The nodes with the given name, in document order.
+  std::span<const std::uint32_t> find_nodes(std::string_view elem) const;
+
+  std::vector<node> nodes;              // in document order
+  std::vector<std::uint32_t> by_name;   // indices into nodes, sorted by name
+};
+
 struct issue;
 
 // Create an <a> element linking to an issue
 auto make_html_anchor(issue const & iss) -> std::string;
 
 }
+
+#endif // INCLUDE_LWG_HTML_UTILS_H
@@ -0,0 +1,256 @@
+//        Copyright the C++ Library Working Group
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// SPDX-License-Identifier: BSL-1.0
+
+#include "issue_cache.h"
+#include "file_utils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Identifies the file format. The version must be incremented whenever the
+// layout below, the 'lwg::issue' struct, or the behaviour of
+// 'lwg::parse_issue_from_file' changes, so that stale entries are not reused.
+// Callers should also include 'lwg::program_fingerprint' in the fingerprint of
+// the cache, so that a forgotten increment does not matter.
+constexpr std::string_view cache_magic = "LWG issue cache\n";
+constexpr std::uint32_t cache_version = 2;
+
+// The cache is a flat binary file. Integers are written in little-endian order
+// and strings are prefixed with their length, so the file can be shared between
+// platforms (although there is little reason to do so).
+struct writer {
+   std::string buf;
+
+   void u64(std::uint64_t n) {
+      for (int i = 0; i != 8; ++i) {
+         buf += static_cast<char>((n >> (8 * i)) & 0xff);
+      }
+   }
+
+   void i64(std::int64_t n) { u64(static_cast<std::uint64_t>(n)); }
+
+   void str(std::string_view s) {
+      u64(s.size());
+      buf += s;
+   }
+};
+
+// Reads the values written by 'writer'.
+// Any attempt to read past the end of the data means the file is truncated or
+// corrupt, and throws 'bad_cache' so that the whole cache is ignored.
+struct bad_cache { };
+
+struct reader {
+   std::string_view data;
+
+   auto u64() -> std::uint64_t {
+      if (data.size() < 8) {
+         throw bad_cache{};
+      }
+      std::uint64_t n = 0;
+      for (int i = 0; i != 8; ++i) {
+         n |= std::uint64_t(static_cast<unsigned char>(data[i])) << (8 * i);
+      }
+      data.remove_prefix(8);
+      return n;
+   }
+
+   auto i64() -> std::int64_t { return static_cast<std::int64_t>(u64()); }
+
+   auto str() -> std::string {
+      auto n = u64();
+      if (data.size() < n) {
+         throw bad_cache{};
+      }
+      std::string s{data.substr(0, n)};
+      data.remove_prefix(n);
+      return s;
+   }
+};
+
+void write_issue(writer & w, lwg::issue const & is) {
+   w.i64(is.num);
+   w.str(is.stat);
+   w.str(is.title);
+   w.str(is.doc_prefix);
+   w.u64(is.tags.size());
+   for (auto const & t : is.tags) {
+      w.str(t.prefix);
+      w.str(t.name);
+   }
+   w.str(is.submitter);
+   w.i64(static_cast<int>(is.date.year()));
+   w.u64(static_cast<unsigned>(is.date.month()));
+   w.u64(static_cast<unsigned>(is.date.day()));
+   w.u64(is.duplicates.size());
+   for (auto const & d : is.duplicates) {
+      w.str(d);
+   }
+   w.str(is.text);
+   w.i64(is.priority);
+   w.str(is.owner);
+   w.str(is.resolution);
+   w.u64(is.has_resolution);
+}
+
+auto read_issue(reader & r) -> lwg::issue {
+   lwg::issue is;
+   is.num = static_cast<int>(r.i64());
+   is.stat = r.str();
+   is.title = r.str();
+   is.doc_prefix = r.str();
+   for (auto n = r.u64(); n != 0; --n) {
+      auto prefix = r.str();
+      auto name = r.str();
+      is.tags.push_back(lwg::section_tag{std::move(prefix), std::move(name)});
+   }
+   is.submitter = r.str();
+   auto y = static_cast<int>(r.i64());
+   auto m = static_cast<unsigned>(r.u64());
+   auto d = static_cast<unsigned>(r.u64());
+   is.date = std::chrono::year{y}/m/d;
+   for (auto n = r.u64(); n != 0; --n) {
+      is.duplicates.insert(r.str());
+   }
+   is.text = r.str();
+   is.priority = static_cast<int>(r.i64());
+   is.owner = r.str();
+   is.resolution = r.str();
+   is.has_resolution = r.u64() != 0;
+   return is;
+}
+
+// Read a binary file, or return an empty string if it cannot be read.
+auto read_binary_file(fs::path const & filename) -> std::string {
+   std::ifstream in{filename, std::ios::binary};
+   std::string s;
+   std::error_code ec;
+   if (auto size = fs::file_size(filename, ec); in and !ec) {
+      s.resize(size);
+      in.read(s.data(), s.size());
+      s.resize(in.gcount());
+   }
+   return s;
+}
+
+} // close unnamed namespace
+
+auto lwg::metadata_fingerprint(fs::path const & meta_data_path) -> std::uint64_t {
+   std::uint64_t h = hash_bytes({});
+   for (auto name : {"section.data", "dates", "paper_titles.txt"}) {
+      auto contents = read_binary_file(meta_data_path / name);
+      // Include the size so that moving bytes between files changes the result.
+      h = hash_bytes(name, h);
+      h = hash_bytes(std::to_string(contents.size()), h);
+      h = hash_bytes(contents, h);
+   }
+   return h;
+}
+
+auto lwg::program_fingerprint(fs::path const & argv0) -> std::uint64_t {
+   // Where it exists, /proc/self/exe is the running program however it was started.
+   std::error_code ec;
+   fs::path program{"/proc/self/exe"};
+   if (!fs::exists(program, ec)) {
+      program = argv0;
+   }
+   try {
+      mapped_file const file{program};
+      return hash_bytes(file.contents());
+   }
+   catch (std::exception const &) {
+      return 0;
+   }
+}
+
+auto lwg::issue_cache::load(fs::path const & filename, std::uint64_t fingerprint) -> issue_cache {
+   issue_cache cache{fingerprint};
+   auto const data = read_binary_file(filename);
+   if (!data.starts_with(cache_magic)) {
+      return cache;
+   }
+
+   try {
+      reader r{std::string_view{data}.substr(cache_magic.size())};
+      if (r.u64() != cache_version or r.u64() != fingerprint) {
+         return cache;
+      }
+      for (auto n = r.u64(); n != 0; --n) {
+         auto name = r.str();
+         entry e;
+         e.hash = r.u64();
+         e.warnings = r.str();
+         e.parsed = read_issue(r);
+         cache.m_entries.insert_or_assign(std::move(name), std::move(e));
+      }
+   }
+   catch (bad_cache const &) {
+      cache.m_entries.clear();
+   }
+   return cache;
+}
+
+void lwg::issue_cache::save(fs::path const & filename) const {
+   writer w;
+   w.buf += cache_magic;
+   w.u64(cache_version);
+   w.u64(m_fingerprint);
+   w.u64(m_entries.size());
+   for (auto const & [name, e] : m_entries) {
+      w.str(name);
+      w.u64(e.hash);
+      w.str(e.warnings);
+      write_issue(w, e.parsed);
+   }
+
+   std::error_code ec;
+   fs::create_directories(filename.parent_path(), ec);
+
+   auto tmp = filename;
+   tmp += ".tmp";
+   {
+      std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+      if (!out.write(w.buf.data(), w.buf.size()) or !out.flush()) {
+         throw std::runtime_error{"Unable to write issue cache " + tmp.string()};
+      }
+   }
+   fs::rename(tmp, filename, ec);
+   if (ec) {
+      fs::remove(tmp, ec);
+      throw std::runtime_error{"Unable to write issue cache " + filename.string()};
+   }
+}
+
+auto lwg::issue_cache::find(std::string const & filename, std::uint64_t hash) const -> entry const * {
+   if (auto it = m_entries.find(filename); it != m_entries.end() and it->second.hash == hash) {
+      return &it->second;
+   }
+   return nullptr;
+}
+
+void lwg::issue_cache::insert(std::string filename, entry e) {
+   m_entries.insert_or_assign(std::move(filename), std::move(e));
+   m_modified = true;
+}
+
+void lwg::issue_cache::retain_only(std::vector<std::string> const & filenames) {
+   for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+      if (std::binary_search(filenames.begin(), filenames.end(), it->first)) {
+         ++it;
+      }
+      else {
+         it = m_entries.erase(it);
+         m_modified = true;
+      }
+   }
+}
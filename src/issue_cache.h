@@ -0,0 +1,80 @@
+#ifndef INCLUDE_LWG_ISSUE_CACHE_H
+#define INCLUDE_LWG_ISSUE_CACHE_H
+
+// standard headers
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// solution specific headers
+#include "issues.h"
+
+namespace lwg
+{
+
+auto metadata_fingerprint(std::filesystem::path const & meta_data_path) -> std::uint64_t;
+  // Return a hash of the files in the 'meta-data' directory that affect how
+  // issues are parsed, i.e. section.data, dates and paper_titles.txt.
+  // Missing files are hashed as if they were empty.
+
+auto program_fingerprint(std::filesystem::path const & argv0) -> std::uint64_t;
+  // Return a hash of the running program, which is found using 'argv0' if the
+  // operating system cannot say where it is. Including this in the fingerprint
+  // of an 'issue_cache' means that a cache written by a different build, which
+  // might parse the issues differently, is never used.
+  // Returns 0 if the program cannot be read.
+
+// An on-disk record of the issues parsed by a previous run.
+// Each entry is keyed by the name of the issue file and a hash of its contents,
+// and the whole cache is discarded if the metadata fingerprint has changed,
+// so an entry is only used if parsing the file again would give the same result.
+//
+// The 'mod_date' of a cached issue is not stored, because it can depend on the
+// file's modification time rather than its contents. It must be recomputed by
+// calling 'report_date_file_last_modified'.
+class issue_cache {
+public:
+   struct entry {
+      std::uint64_t hash;        // hash of the issue file's contents
+      std::string   warnings;    // diagnostics written while parsing the file
+      issue         parsed;
+   };
+
+   explicit issue_cache(std::uint64_t fingerprint) : m_fingerprint{fingerprint} {}
+
+   static auto load(std::filesystem::path const & filename, std::uint64_t fingerprint) -> issue_cache;
+     // Read the cache from 'filename'. If the file does not exist, is not
+     // readable, or was written for a different metadata fingerprint or by
+     // a different version of this program, return an empty cache.
+
+   void save(std::filesystem::path const & filename) const;
+     // Write the cache to 'filename', creating its directory if needed.
+     // The file is replaced atomically, so a concurrent or interrupted run
+     // never leaves a partially written cache behind.
+     // Throws 'runtime_error' if the file cannot be written.
+
+   auto find(std::string const & filename, std::uint64_t hash) const -> entry const *;
+     // Return the entry for 'filename' if the contents hash to 'hash',
+     // or a null pointer otherwise.
+
+   void insert(std::string filename, entry e);
+
+   void retain_only(std::vector<std::string> const & filenames);
+     // Remove the entries for any files not in 'filenames', which must be sorted,
+     // so that the cache does not keep growing as issue files are renamed or removed.
+
+   auto modified() const noexcept -> bool { return m_modified; }
+     // Return 'true' if the cache has changed since it was loaded.
+
+private:
+   std::uint64_t                  m_fingerprint;
+   std::map<std::string, entry>   m_entries;
+   bool                           m_modified = false;
+};
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_ISSUE_CACHE_H
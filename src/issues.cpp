@@ -12,18 +12,17 @@
 #include "issues.h"
 #include "metadata.h"
 #include "status.h"
+#include "date.h"
 #include "html_utils.h"
 
 #include <algorithm>
 #include <cassert>
-#include <istream>
 #include <ostream>
 #include <string>
 #include <stdexcept>
 
 #include <iterator>
 #include <fstream>
-#include <sstream>
 #include <format>
 
 #include <iostream>  // eases debugging
@@ -37,40 +36,130 @@ namespace fs = std::filesystem;
 using std::size_t;
 
 namespace {
-auto parse_date(std::istream & temp) -> std::chrono::year_month_day {
-#if __cpp_lib_chrono >= 201803L
-   std::chrono::year_month_day date{};
-   if (temp >> std::chrono::parse(" %d %b %Y", date))
-      return date;
-   throw std::runtime_error{"date format error"};
-#else
-   using month_idx = std::pair<std::string_view,int>;
-   constexpr month_idx months[] = {
-      {"Apr", 4},{"Aug", 8},{"Dec",12},{"Feb", 2},{"Jan", 1},{"Jul", 7},
-      {"Jun", 6},{"Mar", 3},{"May", 5},{"Nov",11},{"Oct",10},{"Sep", 9}
-   };
+struct bad_issue_file : std::runtime_error {
+   bad_issue_file(std::string const & filename, std::string error_message)
+      : runtime_error{"Error parsing issue file " + filename + ": " + error_message}
+      { }
+};
 
-   int d;
-   std::string month;
-   int y;
-   if (temp >> d >> month >> y)
-   {
-      auto it = std::ranges::find_if(months, 
-         [&](auto m) { return month.starts_with(m);},
-         &month_idx::first);
+// Append 's' to 'out', replacing '<' and '>' and '&' with HTML character references.
+// This is used to turn backtick-quoted inline code into valid XML/HTML.
+void append_escaped(std::string & out, std::string_view s) {
+   for (auto p = s.find_first_of("&<>"); p != s.npos; p = s.find_first_of("&<>")) {
+      out += s.substr(0, p);
+      out += s[p] == '&' ? "&amp;" : s[p] == '<' ? "&lt;" : "&gt;";
+      s.remove_prefix(p + 1);
+   }
+   out += s;
+}
 
-      if (it != std::end(months))
+// Append 's' to 'out', replacing the obsolete <tt> element with <code>.
+void append_replacing_tt(std::string & out, std::string_view s) {
+   std::size_t done = 0;
+   std::size_t next_tt = 0;  // where to look for the next "<tt"
+   for (auto p = s.find('<'); p != s.npos; p = s.find('<', p + 1)) {
+      auto tag = s.substr(p);
+      if (tag.starts_with("</tt>")) {
+         out += s.substr(done, p - done);
+         out += "</code>";
+         done = p + 5;
+      }
+      else if (tag.starts_with("<tt") and p >= next_tt) {
+         if (tag.size() > 3 and (tag[3] == '>' or tag[3] == ' ')) {
+            out += s.substr(done, p - done);
+            out += "<code";
+            done = p + 3;
+         }
+         else {
+            // For compatibility with the old in-place replacement, which
+            // resumed its search five characters after any "<tt" it found.
+            next_tt = p + 5;
+         }
+      }
+   }
+   out += s.substr(done);
+}
+
+// Append 's' to 'out', replacing inline `code` with valid XML,
+// and <tt> with <code> outside the inline code.
+// Unless 'at_end' is true, 's' is followed by a newline in the document,
+// so a backtick is never paired with one beyond the end of 's'.
+void append_inline_code(std::string & out, std::string_view s, bool at_end) {
+   std::size_t done = 0;
+   for (std::size_t p = s.find('`'); p != s.npos; p = s.find('`', p))
+   {
+      char next = p + 1 < s.size() ? s[p+1] : at_end ? '\0' : '\n';
+      if (next == '`')
       {
-         int m = it->second;
-         if (auto ymd = std::chrono::year{y}/m/d; ymd.ok())
-            return ymd;
+         // Some issues use double backtick for ``quotes like this''.
+         // We don't want to do anything here.
+         p += 2;
+         continue;
+      }
+      std::size_t p2 = s.find('`', p + 1);
+      std::size_t eol = s.find('\n', p + 1);
+      if (eol == s.npos and not at_end)
+         eol = s.size();
+      if (p2 > eol)
+      {
+         // Do not treat "`foo\nbar`" as inline code.
+         // Move to the next backtick and check that one.
+         p = p2;
+         continue;
       }
+      append_replacing_tt(out, s.substr(done, p - done));
+      // This class attribute is used by the CSS in src/report_generator.cpp
+      // so that the backticks are still displayed if this occurs inside a
+      // <pre> element (because that always displays in code font anyway).
+      out += "<code class='backtick'>";
+      append_escaped(out, s.substr(p + 1, p2 - p - 1));
+      out += "</code>";
+      p = p2 == s.npos ? s.size() : p2 + 1;
+      done = p;
    }
-   throw std::runtime_error{"date format error"};
-#endif
+   append_replacing_tt(out, s.substr(done));
 }
 
-auto report_date_file_last_modified(std::filesystem::path const & filename, lwg::metadata const& meta) -> std::chrono::year_month_day {
+// True if 'tx' uses any of the markup that 'rewrite_markdown' replaces.
+bool needs_rewriting(std::string_view tx) {
+   return tx.find('`') != tx.npos
+       or tx.find("<tt") != tx.npos
+       or tx.find("</tt>") != tx.npos;
+}
+
+// Replace markdown-style code and obsolete HTML elements with valid XML,
+// writing the result to 'out'.
+// This is done in a single pass over 'tx', appending to 'out', so the cost
+// is linear in the size of the text however many replacements are made.
+void rewrite_markdown(std::string_view tx, std::string & out, std::string const & filename) {
+   out.clear();
+   out.reserve(tx.size() + tx.size() / 4);
+
+   std::string code;  // the escaped content of a ```code block```
+   std::size_t done = 0;
+   for (size_t p = tx.find("\n```\n"); p != tx.npos; p = tx.find("\n```\n", done))
+   {
+      size_t p2 = tx.find("\n```\n", p + 5);
+      if (p2 == tx.npos)
+         throw bad_issue_file{filename, "Unmatched ``` code block: " + std::string(tx.substr(p, 10))};
+
+      append_inline_code(out, tx.substr(done, p - done), false);
+
+      // Replace ```code block``` with valid XML.
+      // Any `inline code` in the block is replaced too, after escaping the block.
+      code.clear();
+      append_escaped(code, tx.substr(p + 5, p2 - p - 5));
+      out += "\n<pre><code>";
+      append_inline_code(out, code, false);
+      out += "\n</code></pre>\n";
+      done = p2 + 5;
+   }
+   append_inline_code(out, tx.substr(done), true);
+}
+
+} // close unnamed namespace
+
+auto lwg::report_date_file_last_modified(std::filesystem::path const & filename, lwg::metadata const & meta) -> std::chrono::year_month_day {
    using namespace std::chrono;
    system_clock::time_point t;
    // NB: Cannot use `native()` instead of `string()`, because on Windows that
@@ -95,96 +184,53 @@ auto report_date_file_last_modified(std::filesystem::path const & filename, lwg:
    return year_month_day(floor<days>(t));
 }
 
-// Replace '<' and '>' and '&' with HTML character references.
-// This is used to turn backtick-quoted inline code into valid XML/HTML.
-std::string escape_special_chars(std::string s) {
-   static const std::vector<std::pair<char, std::string_view>> subs {
-      { '&', "&amp;" }, // this has to come first!
-      { '<', "&lt;" },
-      { '>', "&gt;" },
-   };
-   for (auto [c, r] : subs)
-      for (auto p = s.find(c); p != s.npos; p = s.find(c, p+r.size()))
-         s.replace(p, 1, r);
-   return s;
-}
-
-} // close unnamed namespace
-
-auto lwg::parse_issue_from_file(std::string tx, std::string const & filename,
-  lwg::metadata & meta) -> issue {
-   auto& section_db = meta.section_db;
-   struct bad_issue_file : std::runtime_error {
-      bad_issue_file(std::string const & filename, std::string error_message)
-         : runtime_error{"Error parsing issue file " + filename + ": " + error_message}
-         { }
+auto lwg::parse_issue_header(std::string_view file_contents, std::string const & filename) -> issue_header {
+   // Each lookup stops at the <issue> start tag, so only the start of the file is read.
+   auto get_attr = [&](std::string_view attr) {
+      if (auto o = lwg::get_attribute_of(attr, "issue", file_contents))
+         return *o;
+      throw bad_issue_file(filename, "Unable to find issue " + std::string(attr));
    };
 
-   // Replace ```code block``` with valid XML.
-   for (size_t p = tx.find("\n```\n"); p != tx.npos; p = tx.find("\n```\n", p))
-   {
-      size_t p2 = tx.find("\n```\n", p + 5);
-      if (p2 == tx.npos)
-         throw bad_issue_file{filename, "Unmatched ``` code block: " + tx.substr(p, 10)};
-      auto code = "\n<pre><code>" + escape_special_chars(tx.substr(p + 5, p2 - p - 5)) + "\n</code></pre>\n";
-      tx.replace(p, p2 - p + 5, code);
-      p += code.size();
-   }
+   issue_header h;
+   h.num = lwg::stoi(std::string(get_attr("num")));
+   h.stat = get_attr("status");
+   return h;
+}
 
-   // Replace inline `code` with valid XML.
-   for (size_t p = tx.find('`'); p != tx.npos; p = tx.find('`', p))
-   {
-      if (tx[p+1] == '`')
-      {
-         // Some issues use double backtick for ``quotes like this''.
-         // We don't want to do anything here.
-         p += 2;
-         continue;
-      }
-      size_t p2 = tx.find('`', p + 1);
-      if (p2 > tx.find('\n', p + 1))
-      {
-         // Do not treat "`foo\nbar`" as inline code.
-         // Move to the next backtick and check that one.
-         p = p2;
-         continue;
-      }
-      // This class attribute is used by the CSS in src/report_generator.cpp
-      // so that the backticks are still displayed if this occurs inside a
-      // <pre> element (because that always displays in code font anyway).
-      auto code = "<code class='backtick'>"
-         + escape_special_chars(tx.substr(p + 1, p2 - p - 1))
-         + "</code>";
-      tx.replace(p, p2 - p + 1, code);
-      p += code.size();
+auto lwg::parse_issue_from_file(std::string_view file_contents, std::string const & filename,
+  lwg::metadata const & meta, std::ostream & warnings) -> issue {
+   // The markdown-style rewrites produce a new copy of the text,
+   // but most issues do not use any of them, so only copy it when necessary.
+   std::string rewritten;
+   if (needs_rewriting(file_contents)) {
+      rewrite_markdown(file_contents, rewritten, filename);
+      file_contents = rewritten;
    }
-
-   // <tt> is obsolete in HTML5, replace with <code>:
-   for (auto p = tx.find("<tt"); p != tx.npos; p = tx.find("<tt", p+5))
-      if (tx.at(p+3) == '>' || tx.at(p+3) == ' ')
-         tx.replace(p, 3, "<code");
-   for (auto p = tx.find("</tt>"); p != tx.npos; p = tx.find("</tt>", p+7))
-         tx.replace(p, 5, "</code>");
+   std::string_view const tx = file_contents;
 
    issue is;
 
+   // Index the elements once, so that each lookup below does not rescan the text.
+   lwg::xml_index const doc{tx};
+
    auto get_or_throw = [&filename](const auto& opt, std::string_view what) {
       return opt ? *opt : throw bad_issue_file(filename, "Unable to find issue " + std::string(what));
    };
 
    // Get value from "<issue attr='value'>"
    auto get_attr = [&](std::string_view attr) {
-      return get_or_throw(lwg::get_attribute_of(attr, "issue", tx), attr);
+      return get_or_throw(doc.get_attribute_of(attr, "issue"), attr);
    };
    // Get content from "<elem>content</elem>"
    auto get_elem_content = [&](std::string_view elem) {
-      return get_or_throw(lwg::get_element_content(elem, tx), elem);
+      return get_or_throw(doc.get_element_content(elem), elem);
    };
 
    // Get issue number
    std::string_view num = get_attr("num");
    if (!filename.ends_with(std::format("issue{:0>4}.xml", num)))
-     std::cerr << "warning: issue number " << num << " in " << filename << " does not match issue number\n";
+     warnings << "warning: issue number " << num << " in " << filename << " does not match issue number\n";
    is.num = lwg::stoi(std::string(num));
 
    // Get issue status
@@ -205,9 +251,9 @@ auto lwg::parse_issue_from_file(std::string tx, std::string const & filename,
 
    // Get issue sections
    std::string_view sections = get_elem_content("section");
-   while (auto sref = lwg::get_element("sref", sections))
+   for (auto const & sref : doc.get_elements("sref", sections))
    {
-      if (auto attr = lwg::get_attribute("ref", sref->outer))
+      if (auto attr = lwg::get_attribute("ref", sref.outer))
       {
          if (attr->starts_with('[') and attr->ends_with(']'))
          {
@@ -221,16 +267,9 @@ auto lwg::parse_issue_from_file(std::string tx, std::string const & filename,
          tag.prefix = is.doc_prefix;
          tag.name = *attr;
          is.tags.emplace_back(tag);
-         if (section_db.find(is.tags.back()) == section_db.end()) {
-             section_num num{};
-             num.prefix = tag.prefix;
-             num.num.push_back(99);
-             section_db[is.tags.back()] = num;
-         }
       }
       else
          throw bad_issue_file{filename, "Missing ref attribute in <sref>"};
-      sections.remove_prefix(sref->outer.data() - sections.data() + sref->outer.size());
    }
 
    if (is.tags.empty()) {
@@ -244,33 +283,34 @@ auto lwg::parse_issue_from_file(std::string tx, std::string const & filename,
    auto datestr = get_elem_content("date");
 
    try {
-#ifdef __cpp_lib_sstream_from_string_view
-      std::istringstream temp{datestr};
-#else
-      std::istringstream temp{std::string{datestr}};
-#endif
-      is.date = parse_date(temp);
+      is.date = lwg::parse_date_or_throw(datestr);
    }
    catch(std::exception const & ex) {
       throw bad_issue_file{filename, ex.what()};
    }
 
    // Get modification date
-   is.mod_date = report_date_file_last_modified(filename, meta);
+   is.mod_date = lwg::report_date_file_last_modified(filename, meta);
 
    // Get priority - this element is optional
-   if (auto o = lwg::get_element_content("priority", tx))
+   if (auto o = doc.get_element_content("priority"))
       is.priority = lwg::stoi(std::string(*o));
 
    // Trim text to <discussion>
-   if (auto k = tx.find("<discussion>"); k != tx.npos)
-      tx.replace(0, k, "<issue>");
+   // This is the only copy of the text that is kept, unless it was rewritten above.
+   if (auto discussion = doc.get_element("discussion")) {
+      auto k = discussion->outer.data() - tx.data();
+      constexpr std::string_view start_tag = "<issue>";
+      is.text.reserve(start_tag.size() + tx.size() - k);
+      is.text = start_tag;
+      is.text += tx.substr(k);
+   }
    else
       throw bad_issue_file{filename, "Unable to find issue discussion"};
 
    // Find out if issue has a proposed resolution
    if (is_active(is.stat)  or  "Pending WP" == is.stat) {
-      auto resolution = lwg::get_element_content("resolution", tx);
+      auto resolution = doc.get_element_content("resolution");
       // Ignore small amounts of whitespace between tags, with no actual resolution
       is.has_resolution = resolution.has_value() && resolution->length() >= 15;
 
@@ -285,6 +325,62 @@ auto lwg::parse_issue_from_file(std::string tx, std::string const & filename,
       is.has_resolution = true;
    }
 
-   is.text = std::move(tx);
    return is;
 }
+
+void lwg::add_unknown_sections(issue const & is, section_map & section_db) {
+   for (auto const & tag : is.tags) {
+      if (section_db.find(tag) == section_db.end()) {
+         section_num num{};
+         num.prefix = tag.prefix;
+         num.num.push_back(99);
+         section_db[tag] = num;
+      }
+   }
+}
+
+void lwg::add_referenced_sections(issue const & is, section_map & section_db) {
+   // Find the <sref> elements in the same way as 'format_issue_as_html' does,
+   // so that exactly the sections it will look up are added.
+   std::string_view const text = is.text;
+   for (auto i = text.find('<'); i < text.size(); i = text.find('<', i + 1)) {
+      auto const markup = lwg::scan_issue_tag(text, i);
+      if (markup.kind == lwg::issue_tag::malformed) {
+         // 'format_issue_as_html' will report it.
+         return;
+      }
+      if (markup.kind == lwg::issue_tag::empty_elem_tag and markup.name == "sref") {
+         if (auto ref = lwg::get_attribute_of("ref", "sref", text.substr(i)); ref and !ref->empty()) {
+            section_db.try_emplace(find_section_reference(section_db, is.doc_prefix, ref->substr(1, ref->size() - 2)));
+         }
+      }
+      i = markup.last;
+   }
+}
+
+lwg::issue_index::issue_index(std::span<const issue> issues)
+   : m_issues{issues}
+{
+   // A limit on the size of the table, far more than the number of issues there
+   // will ever be, so that a mistyped number cannot use up all the memory.
+   constexpr int max_num = 1'000'000;
+   int largest = -1;
+   for (auto const & is : issues) {
+      if (is.num < 0 or is.num > max_num) {
+         throw std::runtime_error{"Issue number out of range: " + std::to_string(is.num)};
+      }
+      largest = std::max(largest, is.num);
+   }
+
+   m_positions.resize(largest + 1);
+   for (std::size_t i = 0; i != issues.size(); ++i) {
+      m_positions[issues[i].num] = static_cast<std::uint32_t>(i + 1);
+   }
+}
+
+auto lwg::issue_index::find(int num) const noexcept -> issue const * {
+   if (num < 0 or static_cast<std::size_t>(num) >= m_positions.size() or m_positions[num] == 0) {
+      return nullptr;
+   }
+   return &m_issues[m_positions[num] - 1];
+}
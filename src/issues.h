@@ -3,9 +3,14 @@
 
 // standard headers
 #include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
 #include <map>
 #include <set>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // solution specific headers
@@ -31,16 +36,70 @@ struct issue {
    std::string                owner;          // person identified as taking ownership of drafting/progressing the issue
    std::string                resolution;     // extracted resolution text (if any), also present in 'text'
    bool                       has_resolution; // 'true' if 'text' contains a proposed resolution
+   std::string                anchor;         // HTML link to the issue, see 'make_html_anchor'; set once the issues are all parsed
 };
 
-auto parse_issue_from_file(std::string file_contents, std::string const & filename, lwg::metadata & meta) -> issue;
+// An index of issues by number. Issue numbers are small and nearly contiguous,
+// so the index is a table with an entry for every number up to the largest,
+// and each lookup takes constant time.
+class issue_index {
+public:
+   explicit issue_index(std::span<const issue> issues);
+     // Index the 'issues', which must outlive the index.
+     // Throws 'runtime_error' if an issue number is negative or unreasonably large.
+
+   auto find(int num) const noexcept -> issue const *;
+     // Return the issue numbered 'num', or a null pointer if there is none.
+
+   auto issues() const noexcept -> std::span<const issue> { return m_issues; }
+
+private:
+   std::span<const issue>     m_issues;
+   std::vector<std::uint32_t> m_positions;   // 1 + the position of each issue in 'm_issues', or 0
+};
+
+auto parse_issue_from_file(std::string_view file_contents, std::string const & filename,
+                           lwg::metadata const & meta, std::ostream & warnings) -> issue;
   // Seems appropriate constructor behavior.
   //
-  // Note that 'section_db' is modifiable as new (unknown) sections may be inserted,
-  // typically for issues reported against older documents with sections that have
-  // since been removed, replaced or merged.
+  // Note that 'meta' is not modified, so several issues can be parsed concurrently.
+  // Sections that are not in 'meta.section_db' must be added afterwards by
+  // calling 'add_unknown_sections'.
   //
   // The filename is passed only to improve diagnostics.
+  // Non-fatal problems with the issue are written to 'warnings'.
+
+struct issue_header {
+   int         num;    // ID - issue number
+   std::string stat;   // current status of the issue
+};
+
+auto parse_issue_header(std::string_view file_contents, std::string const & filename) -> issue_header;
+  // Return the number and status from the <issue num="..." status="..."> start tag,
+  // without looking at the rest of the issue, so that only the start of the file
+  // is read. This is much faster than 'parse_issue_from_file', but the rest of the
+  // issue is not checked for errors.
+  //
+  // The filename is passed only to improve diagnostics.
+
+auto report_date_file_last_modified(std::filesystem::path const & filename, lwg::metadata const & meta) -> chrono::year_month_day;
+  // Return the date that the issue file 'filename' was last changed, which is
+  // the Git commit date recorded in 'meta.git_commit_times' if there is one,
+  // or else the modification time of the file.
+
+void add_unknown_sections(issue const & is, section_map & section_db);
+  // Insert any of the sections in 'is.tags' that are not already in 'section_db',
+  // typically for issues reported against older documents with sections that have
+  // since been removed, replaced or merged.  Unknown sections are given the
+  // section number 99, so they sort after all the known ones.
+
+void add_referenced_sections(issue const & is, section_map & section_db);
+  // Insert any of the sections referred to by <sref> elements in 'is.text' that
+  // are not already in 'section_db', with an empty section number, in the order
+  // that they appear. Which section a reference resolves to depends on the
+  // sections already in 'section_db' (see 'find_section_reference'), so this
+  // must be called for each issue in order of issue number, after calling
+  // 'add_unknown_sections' for every issue.
 
 
 inline int stoi(const std::string& s)
@@ -39,52 +39,56 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <filesystem>
 namespace fs = std::filesystem;
 
 // solution specific headers
+#include "file_utils.h"
 #include "issues.h"
 #include "metadata.h"
+#include "parallel.h"
 
 
-auto read_file_into_string(fs::path const & filename) -> std::string {
-   // read a text file completely into memory, and return its contents as
-   // a 'string' for further manipulation.
-
-   std::ifstream infile{filename};
-   if (!infile.is_open()) {
-      throw std::runtime_error{"Unable to open file " + filename.string()};
-   }
-
-   std::istreambuf_iterator<char> first{infile}, last{};
-   return std::string {first, last};
-}
-
 // Issue-list specific functionality for the rest of this file
 // ===========================================================
 
-auto is_issue_xml_file(fs::directory_entry const & e) {
-   if (e.is_regular_file()) {
-      auto f = e.path().filename().string();
-      return f.starts_with("issue") && f.ends_with(".xml");
-   }
-   return false;
-}
-
-void filter_issues(fs::path const & issues_path, lwg::metadata & meta, std::function<bool(lwg::issue const &)> predicate) {
+void filter_issues(fs::path const & issues_path, lwg::metadata const & meta, std::function<bool(lwg::issue const &)> predicate) {
    // Open the specified directory, 'issues_path', and iterate all the '.xml' files
    // it contains, parsing each such file as an LWG issue document. Collect
    // the number of every issue that satisfies the 'predicate'.
 
   std::vector<int> nums;
-  for (auto ent : fs::directory_iterator(issues_path)) {
-     if (is_issue_xml_file(ent)) {
-         fs::path const issue_file = ent.path();
-        auto const iss = parse_issue_from_file(read_file_into_string(issue_file), issue_file.string(), meta);
-        if (predicate(iss)) {
-          nums.push_back(iss.num);
-        }
+  for (auto const & issue_file : lwg::issue_files(issues_path)) {
+     lwg::mapped_file const file{issue_file};
+     auto const iss = parse_issue_from_file(file.contents(), issue_file.string(), meta, std::cerr);
+     if (predicate(iss)) {
+       nums.push_back(iss.num);
+     }
+  }
+  // Write the sorted issue numbers to stdout.
+  std::ranges::sort(nums);
+  std::ranges::copy(nums, std::ostream_iterator<int>(std::cout, "\n"));
+}
+
+void filter_issue_headers(fs::path const & issues_path, unsigned jobs, std::string_view status) {
+   // As for 'filter_issues', but only read the number and status of each issue,
+   // which is all that is needed to select issues by status.
+   // The files are read by up to 'jobs' threads.
+
+  auto const files = lwg::issue_files(issues_path);
+  std::vector<lwg::issue_header> headers(files.size());
+  lwg::parallel_for(files.size(), jobs, [&](std::size_t i) {
+     lwg::mapped_file const file{files[i]};
+     headers[i] = lwg::parse_issue_header(file.contents(), files[i].string());
+  });
+
+  std::vector<int> nums;
+  for (auto const & h : headers) {
+     if (h.stat == status) {
+       nums.push_back(h.num);
      }
   }
   // Write the sorted issue numbers to stdout.
@@ -102,23 +106,49 @@ void check_is_directory(fs::path const & directory) {
 
 int main(int argc, char const* argv[]) {
    try {
-      if (argc != 2) {
+      unsigned jobs = lwg::jobs_from_environment();
+      bool full = false;
+
+      // Options must come before the status, e.g. "list_issues -j 8 Ready".
+      // "-j N" reads the issues using N threads, "-j 0" uses one thread per core.
+      // The LWG_JOBS environment variable sets the default number of threads.
+      // "--full" parses and checks every issue, instead of only reading the status.
+      std::vector<std::string_view> args(argv + 1, argv + argc);
+      while (!args.empty() && args.front().starts_with("-")) {
+         std::string_view opt = args.front();
+         args.erase(args.begin());
+         if (opt == "--full") {
+            full = true;
+         }
+         else if (opt.starts_with("-j")) {
+            jobs = lwg::parse_jobs_option(opt, args);
+         }
+         else {
+            throw std::runtime_error{"Unknown option " + std::string(opt)};
+         }
+      }
+
+      if (args.size() != 1) {
          std::cerr << "Must specify exactly one status\n";
          return 2;
       }
-      std::string const status{argv[1]};
+      std::string const status{args[0]};
   
       fs::path path = fs::current_path();
 
       check_is_directory(path);
 
-      auto metadata = lwg::metadata::read_from_path(path, /*verbose=*/ false);
+      if (full) {
+         auto metadata = lwg::metadata::read_from_path(path, /*verbose=*/ false);
 
-      filter_issues(path / "xml/", metadata, [status](lwg::issue const & iss) { return status == iss.stat; });
+         filter_issues(path / "xml/", metadata, [status](lwg::issue const & iss) { return status == iss.stat; });
+      }
+      else {
+         filter_issue_headers(path / "xml/", jobs, status);
+      }
    }
    catch(std::exception const & ex) {
       std::cout << ex.what() << std::endl;
       return -1;
    }
 }
-
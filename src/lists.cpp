@@ -31,21 +31,27 @@
 
 // standard headers
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cctype>
+#include <charconv>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <optional>
 #include <ranges>
-#include <regex>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -53,111 +59,158 @@
 #include <filesystem>
 namespace fs = std::filesystem;
 
+#if __has_include(<sys/inotify.h>)
+# include <cerrno>
+# include <poll.h>
+# include <sys/inotify.h>
+# include <unistd.h>
+# define LWG_HAVE_INOTIFY 1
+#endif
+
 // solution specific headers
+#include "file_utils.h"
 #include "html_utils.h"
+#include "issue_cache.h"
 #include "issues.h"
 #include "mailing_info.h"
+#include "output_manifest.h"
+#include "papers.h"
+#include "parallel.h"
 #include "report_generator.h"
 #include "sections.h"
+#include "status_diff.h"
 
 
-auto read_file_into_string(fs::path const & filename) -> std::string {
-   // read a text file completely into memory, and return its contents as
-   // a 'string' for further manipulation.
+// Issue-list specific functionality for the rest of this file
+// ===========================================================
 
-   std::ifstream infile{filename};
-   if (!infile.is_open()) {
-      throw std::runtime_error{"Unable to open file " + filename.string()};
+void register_sections(std::vector<lwg::issue const *> issues, lwg::metadata & meta) {
+   // Add every section that the 'issues' are filed against, or refer to, that
+   // is not already in the section index, 'meta.section_db', then make the links
+   // to every section in 'meta.section_links'. After this the index is complete,
+   // so formatting and rendering the issues only reads it, and can share it
+   // between threads.
+
+   auto & section_db = meta.section_db;
+   for (auto is : issues) {
+      lwg::add_unknown_sections(*is, section_db);
    }
 
-   std::istreambuf_iterator<char> first{infile}, last{};
-   return std::string {first, last};
-}
+   std::ranges::sort(issues, {}, &lwg::issue::num);
+   for (auto is : issues) {
+      lwg::add_referenced_sections(*is, section_db);
+   }
 
-// Issue-list specific functionality for the rest of this file
-// ===========================================================
+   meta.section_links = lwg::section_link_map{section_db};
+}
 
-auto is_issue_xml_file(fs::directory_entry const & e) {
-   if (e.is_regular_file()) {
-      auto f = e.path().filename().string();
-      return f.starts_with("issue") && f.ends_with(".xml");
+void register_sections(std::span<lwg::issue const> issues, lwg::metadata & meta) {
+   std::vector<lwg::issue const *> all;
+   for (auto const & is : issues) {
+      all.push_back(&is);
    }
-   return false;
+   register_sections(std::move(all), meta);
 }
 
-auto read_issues(fs::path const & issues_path, lwg::metadata & meta) -> std::vector<lwg::issue> {
-   // Open the specified directory, 'issues_path', and iterate all the '.xml' files
-   // it contains, parsing each such file as an LWG issue document.  Return the set
-   // of issues as a vector.
+auto read_issues(std::span<fs::path const> files, lwg::metadata const & meta, unsigned jobs,
+                 lwg::issue_cache * cache, bool may_change = false) -> std::vector<lwg::issue> {
+   // Parse each of the specified 'files' as an LWG issue document.
+   // Return the set of issues as a vector, in the same order as 'files'.
+   //
+   // The files are parsed by up to 'jobs' threads, but warnings and errors are
+   // reported in filename order, so the output does not depend on 'jobs'.
+   // Unknown sections are not added to 'meta.section_db', see 'register_sections'.
+   //
+   // If 'cache' is not null, files whose contents have not changed since they
+   // were added to the cache are not parsed again, and the cache is updated with
+   // the results for every other file.
+   //
+   // If 'may_change' is true the files can be modified while they are read,
+   // so they are not mapped into memory, see 'lwg::mapped_file'.
+
+   std::vector<lwg::issue> issues(files.size());
+   std::vector<std::string> warnings(files.size());
+   std::vector<std::exception_ptr> errors(files.size());
+   std::vector<std::uint64_t> hashes(files.size());
+   std::vector<char> parsed(files.size());
+   lwg::parallel_for(files.size(), jobs, [&](std::size_t i) {
+      try {
+         lwg::mapped_file const file{files[i], may_change};
+         if (cache) {
+            hashes[i] = lwg::hash_bytes(file.contents());
+            if (auto e = cache->find(files[i].string(), hashes[i])) {
+               issues[i] = e->parsed;
+               issues[i].mod_date = lwg::report_date_file_last_modified(files[i], meta);
+               warnings[i] = e->warnings;
+               return;
+            }
+         }
+         std::ostringstream diag;
+         issues[i] = parse_issue_from_file(file.contents(), files[i].string(), meta, diag);
+         warnings[i] = std::move(diag).str();
+         parsed[i] = true;
+      }
+      catch (...) {
+         errors[i] = std::current_exception();
+      }
+   });
+
+   for (std::size_t i = 0; i != files.size(); ++i) {
+      std::cerr << warnings[i];
+      if (errors[i]) {
+         std::rethrow_exception(errors[i]);
+      }
+   }
 
-   std::vector<lwg::issue> issues{};
-   for (auto ent : fs::directory_iterator(issues_path)) {
-      if (is_issue_xml_file(ent)) {
-         fs::path const issue_file = ent.path();
-         issues.emplace_back(parse_issue_from_file(read_file_into_string(issue_file), issue_file.string(), meta));
+   if (cache) {
+      std::vector<std::string> names;
+      for (std::size_t i = 0; i != files.size(); ++i) {
+         names.push_back(files[i].string());
+         if (parsed[i]) {
+            cache->insert(names.back(), {hashes[i], warnings[i], issues[i]});
+         }
       }
+      std::ranges::sort(names);
+      cache->retain_only(names);
    }
 
    return issues;
 }
 
 
-auto read_issues_from_toc(std::string const & s) -> std::vector<std::tuple<int, std::string>> {
-   // parse all issues from the specified stream, 'is'.
-   // Throws 'runtime_error' if *any* parse step fails
-   //
-   // We assume 'is' refers to a "toc" html document, for either the current or a previous issues list.
-   // The TOC file consists of a sequence of HTML <tr> elements - each element is one issue/row in the table
-   //    First we read the whole stream into a single 'string'
-   //    Then we search the string for the first <tr> marker
-   //       The first row is the title row and does not contain an issue.
-   //       If we cannot find the first row, we flag an error and exit
-   //    Next we loop through the string, searching for <tr> markers to indicate the start of each issue
-   //       We parse the issue number and status from each row, and append a record to the result vector
-   //       If any parse fails, throw a runtime_error
-   //    If debugging, display the results to 'cout'
-
-   // Skip the title row
-   auto i = s.find("<tr>");
-   if (std::string::npos == i) {
-      throw std::runtime_error{"Unable to find the first (title) row"};
-   }
-
-   auto extract_link_text = [&] (std::string desc) mutable {
-      i = s.find("</a>", i);
-      auto j = s.rfind('>', i);
-      if (j == std::string::npos) {
-         throw std::runtime_error{"unable to parse issue "+desc+": can't find beginning bracket"};
-      }
-      return s.substr(j+1, i-j-1);
-   };
+auto read_issue_headers(std::span<fs::path const> files, unsigned jobs) -> std::vector<lwg::issue_status> {
+   // Return the number and status of the issue in each of the specified 'files',
+   // sorted by number, reading only the <issue> start tag of each file.
+   // The files are read by up to 'jobs' threads.
+   std::vector<lwg::issue_status> issues(files.size());
+   lwg::parallel_for(files.size(), jobs, [&](std::size_t i) {
+      lwg::mapped_file const file{files[i]};
+      auto h = lwg::parse_issue_header(file.contents(), files[i].string());
+      issues[i] = {h.num, std::move(h.stat)};
+   });
+   std::ranges::sort(issues);
+   return issues;
+}
 
-   // Read all issues in table
-   std::vector<std::tuple<int, std::string>> issues;
-   for(;;) {
-      i = s.find("<tr>", i+4);
-      if (i == std::string::npos) {
-         break;
-      }
-      int num = lwg::stoi(extract_link_text("number"));
-      i += 4;
-      std::string status = extract_link_text("status");
-      if (status == "(i)") {
-        i += 4;
-        status = extract_link_text("status");
+auto read_old_issues(fs::path const & meta_path) -> std::vector<std::tuple<int, std::string>> {
+   // Return the number and status of each issue in the previous revision of the lists,
+   // from the snapshot 'lwg-toc.old.txt' in 'meta_path' if there is one, or else by
+   // scraping the table of contents of the previous revision, 'lwg-toc.old.html'.
+   // Either way they are sorted by number, as 'diff_issue_statuses' requires.
+   auto const snapshot = meta_path / "lwg-toc.old.txt";
+   if (fs::exists(snapshot)) {
+      if (auto issues = lwg::read_status_snapshot(lwg::read_file_into_string(snapshot))) {
+         return *std::move(issues);
       }
-
-      issues.emplace_back(num, status);
    }
-
-   return issues;
+   return lwg::read_issue_statuses(meta_path / "lwg-toc.old.html");
 }
 
 namespace {
    // A struct the captures the context of an error.
    struct Context
    {
-      Context(const std::string& txt, std::size_t pos) : text(txt), pos(pos)
+      Context(std::string_view txt, std::size_t pos) : text(txt), pos(pos)
       { }
 
       std::string_view text;
@@ -212,38 +265,68 @@ namespace {
 
 namespace
 {
-   std::map<std::string_view, std::pair<std::string_view, std::string_view>, std::less<>> substitutions {
-      { "discussion", {"<p><b>Discussion:</b></p>", ""} },
-         { "issue", {} },
-         { "resolution", {} },
-         { "rationale", {"<p><b>Rationale:</b></p>", ""} },
-         { "duplicate", {} },
-         { "note", { "<p><i>[", "]</i></p>\n"} },
-         { "superseded",
-            { "<details class='superseded'>"
-              "<summary>Previous resolution [SUPERSEDED]</summary>\n",
-              "</details>" } },
+   // The replacements for the start and end tags of elements that are
+   // reformatted as HTML.
+   struct substitution {
+      std::string_view tag;
+      std::string_view start;
+      std::string_view end;
    };
-}
 
-// The title of the specified paper, formatted as an HTML title="..." attribute.
-std::string paper_title_attr(std::string paper_number, lwg::metadata& meta) {
-   auto title = meta.paper_titles[paper_number];
-   if (!title.empty())
-   {
-      title = lwg::replace_reserved_char(std::move(title), '&', "&amp;");
-      title = lwg::replace_reserved_char(std::move(title), '"', "&quot;");
-      title = " title=\"" + title + "\"";
+   constexpr substitution substitutions[] {
+      { "discussion", "<p><b>Discussion:</b></p>", "" },
+      { "duplicate", {}, {} },
+      { "issue", {}, {} },
+      { "note", "<p><i>[", "]</i></p>\n" },
+      { "rationale", "<p><b>Rationale:</b></p>", "" },
+      { "resolution", {}, {} },
+      { "superseded",
+         "<details class='superseded'>"
+         "<summary>Previous resolution [SUPERSEDED]</summary>\n",
+         "</details>" },
+   };
+
+   static_assert(std::ranges::is_sorted(substitutions, {}, &substitution::tag));
+
+   constexpr auto find_substitution(std::string_view tag) -> substitution const * {
+      auto r = std::ranges::lower_bound(substitutions, tag, {}, &substitution::tag);
+      return r != std::ranges::end(substitutions) and r->tag == tag ? r : nullptr;
    }
-   return title;
+
+   // A stack of the names of the open elements, which refer to the text being
+   // formatted. The capacity is much more than the deepest nesting in any issue,
+   // so the stack never needs to allocate memory. 'full()' must be checked before
+   // 'push_back', so that the caller can report where the tags are nested too deeply.
+   class tag_stack {
+   public:
+      auto empty() const noexcept -> bool { return m_size == 0; }
+      auto full() const noexcept -> bool { return m_size == m_tags.size(); }
+      auto back() const noexcept -> std::string_view { return m_tags[m_size - 1]; }
+      void pop_back() noexcept { --m_size; }
+
+      void push_back(std::string_view tag) noexcept {
+         assert(!full());
+         m_tags[m_size++] = tag;
+      }
+
+   private:
+      std::array<std::string_view, 64> m_tags;
+      std::size_t m_size = 0;
+   };
 }
 
-void format_issue_as_html(lwg::issue & is,
-                          std::span<lwg::issue> issues,
-                          lwg::metadata & meta) {
+// The other issues that an issue refers to, as found by 'format_issue_as_html'.
+struct issue_references {
+   std::vector<int> irefs;        // shown as links, in the text or the resolution
+   std::vector<int> duplicates;   // in the <duplicate> element
+};
+
+auto format_issue_as_html(lwg::issue & is,
+                          lwg::issue_index const & issues,
+                          lwg::metadata const & meta) -> issue_references {
 
-   auto& section_db = meta.section_db;
-   std::vector<std::string> tag_stack; // stack of open XML tags as we parse
+   ::tag_stack tag_stack; // stack of open XML tags as we parse
+   issue_references references;
 
    // Used by fix_tags to report errors.
    auto fail = [&is] (std::string_view reason, const Context& ctx) {
@@ -283,13 +366,6 @@ void format_issue_as_html(lwg::issue & is,
 #endif
    };
 
-   // Check whether the character following a '<' is well-formed.
-   // It has to be an opening or closing tag like <foo> or </foo>
-   // or the start of a comment like <!--.
-   auto start_element_or_comment = [](char c) {
-      return std::isalpha(c) || c == '/' || c == '!';
-   };
-
    // Reformat the issue text for the specified 'is' as valid HTML, replacing all the issue-list
    // specific XML markup as appropriate:
    //   tag             replacement
@@ -305,196 +381,184 @@ void format_issue_as_html(lwg::issue & is,
    //   note            <p><i>[NOTE CONTENTS]</i></p>
    //   !--             comments are simply erased
    //
-   // In addition, as duplicate issues are discovered, the duplicates are marked up
-   // in the supplied range [first_issue,last_issue).  Similarly, if an unexpected
-   // (unknown) section is discovered, it will be inserted into the supplied
-   // section index, 'section_db'.
-   //
-   // The behavior is undefined unless the issues in the supplied span are sorted by issue-number.
+   // In addition, the numbers of the issues that 'is' refers to are returned, so that
+   // the duplicates can be marked up once all issues are formatted (see 'mark_duplicates'),
+   // and so that 'is' can be formatted again when the link to one of them changes.
+   // Only 'is' is modified, so several issues can be formatted concurrently.
+   // Every section referred to must already be in the section index, and have a link
+   // in 'meta.section_links' (see 'register_sections').
    //
    // Essentially, this function is a tiny xml-parser driven by a stack of open tags, that pops as tags
    // are closed.
 
    auto fix_tags = [&](std::string &s) {
 
-      // Loop over the input looking for '< characters.
-      // Cannot rewrite as range-based for-loop as the string 's' is modified within the loop.
-      for (auto i = s.find('<'); i < s.size(); i = s.find('<', i+1)) {
-         Context context{s, i};
+      // The source is read once, from left to right, and the reformatted text
+      // is appended to 'out', so the cost is linear in the size of the text.
+      // Markup that is copied unchanged is appended in blocks: 'copied' is the
+      // end of the source that has been appended to 'out' so far.
+      std::string_view const src = s;
+      std::string out;
+      out.reserve(src.size() + src.size() / 4);
+      std::size_t copied = 0;
+
+      // Replace the markup in [i,j] with 'r'.
+      auto replace = [&](std::size_t i, std::size_t j, std::string_view r) {
+         out.append(src, copied, i - copied);
+         out += r;
+         copied = j + 1;
+      };
 
-         if (!start_element_or_comment(s[i+1])) {
-            fail("Unescaped '<'", context);
-         }
+      // Loop over the input looking for '< characters.
+      for (auto i = src.find('<'); i < src.size(); i = src.find('<', i+1)) {
+         Context context{src, i};
 
-         auto j = s.find('>', i);
-         if (j == std::string::npos) {
-            fail("Missing '>'", context);
+         auto const markup = lwg::scan_issue_tag(src, i);
+         if (markup.kind == lwg::issue_tag::malformed) {
+            fail(markup.error, context);
          }
 
-         std::string tag;
-         {
-            std::istringstream iword{s.substr(i+1, j-i-1)};
-            iword >> tag;
-         }
+         auto const j = markup.last;
+         std::string_view const tag = markup.name;
 
-         if (tag.empty()) {
-            fail("Unexpected <>", context);
+         if (markup.kind == lwg::issue_tag::comment) {
+            // comments are simply erased
+            replace(i, j, {});
+            i = j;
+            continue;
          }
 
-         if (tag[0] == '/') { // closing tag
-             tag.erase(tag.begin());
-
+         if (markup.kind == lwg::issue_tag::end_tag) {
              if (tag_stack.empty()  or  tag != tag_stack.back()) {
                 fail_mismatched_tag(tag, context);
              }
 
              tag_stack.pop_back();
-             if (auto r = substitutions.find(tag); r != substitutions.end()) {
-                 s.replace(i, j-i + 1, r->second.second);
-                 i += r->second.second.size() - 1;
-             }
-             else {
-                 i = j;
+             if (auto r = find_substitution(tag)) {
+                 replace(i, j, r->end);
              }
-
+             i = j;
              continue;
          }
 
-         if (s[j-1] == '/') { // self-closing tag: sref, iref, paper
+         if (markup.kind == lwg::issue_tag::empty_elem_tag) { // sref, iref, paper
 
-            std::string_view attrs(s);
-            attrs.remove_prefix(i);
+            std::string_view attrs = src.substr(i);
 
             // format section references
             if (tag == "sref") {
-               lwg::section_tag tag;
-               tag.prefix = is.doc_prefix;
                auto section_name = get_attribute_value("ref", "sref", attrs, context);
-               tag.name = section_name.substr(1, section_name.size() - 2);
-
-               // heuristic: if the name is not found using the doc_prefix, try
-               // using no prefix (i.e. the C++ standard itself)
-               if (!tag.prefix.empty() && section_db.find(tag) == section_db.end())
-               {
-                 //std::cout << "issue:" << is.num << " tag" << tag << '\n';
-                 lwg::section_tag fallback_tag;
-                 fallback_tag.name = tag.name;
-                 if (section_db.find(fallback_tag) != section_db.end())
-                 {
-                   //std::cout << "bingo\n";
-                   tag = fallback_tag;
-                   //std::cout << "section_tag=\"" << tag.prefix << "\", \"" << tag.name << "\"\n";
-                 }
-               }
-
-               j -= i - 1;
-               std::string r = lwg::format_section_tag_as_link(section_db, tag);
-               s.replace(i, j, r);
-               i += r.size() - 1;
-               continue;
+               replace(i, j, meta.section_links.find_reference(is.doc_prefix, section_name.substr(1, section_name.size() - 2)));
             }
 
             // format issue references
             else if (tag == "iref") {
-               std::string r{get_attribute_value("ref", "iref", attrs, context)};
+               auto ref = get_attribute_value("ref", "iref", attrs, context);
+               ref.remove_prefix(std::min(ref.find_first_not_of(" \t\n\v\f\r"), ref.size()));
                int num;
-               {
-                  std::istringstream temp{r};
-                  temp >> num;
-                  if (temp.fail()) {
-                     fail("Bad number in <iref>", context);
-                  }
+               if (std::from_chars(ref.data(), ref.data() + ref.size(), num).ec != std::errc{}) {
+                  fail("Bad number in <iref>", context);
                }
 
-               auto n = std::ranges::lower_bound(issues, num, {}, &lwg::issue::num);
-               if (n == issues.end()  or  n->num != num) {
-                  fail("Could not find issue " + r + " for <iref>", context);
+               auto n = issues.find(num);
+               if (!n) {
+                  fail("Could not find issue " + std::string(ref) + " for <iref>", context);
                }
 
                if (!tag_stack.empty()  and  tag_stack.back() == "duplicate") {
-                  n->duplicates.insert(make_html_anchor(is));
-                  is.duplicates.insert(make_html_anchor(*n));
-                  r.clear();
+                  references.duplicates.push_back(num);
+                  replace(i, j, {});
                }
                else {
-                  r = make_html_anchor(*n);
-                  r += "<sup><a href=\"https://cplusplus.github.io/LWG/issue";
-                  r += std::to_string(num);
-                  r += "\" title=\"Latest snapshot\">(i)</a></sup>";
+                  references.irefs.push_back(num);
+                  replace(i, j, n->anchor);
+                  out += "<sup><a href=\"https://cplusplus.github.io/LWG/issue";
+                  out += std::to_string(num);
+                  out += "\" title=\"Latest snapshot\">(i)</a></sup>";
                }
-
-               j -= i - 1;
-               s.replace(i, j, r);
-               i += r.size() - 1;
-               continue;
             }
             else if (tag == "paper") {
-               std::string paper_number{get_attribute_value("num", "paper", attrs, context)};
-               static const std::regex acceptable_numbers(R"(N\d+|[DP]\d+R\d+|[DP]\d+)", std::regex::icase);
-
-               if (!std::regex_match(paper_number, acceptable_numbers)) {
-                  fail("Invalid paper number '" + paper_number + "'", context);
+               auto num = get_attribute_value("num", "paper", attrs, context);
+               auto const paper = lwg::parse_paper_number(num);
+               if (!paper) {
+                  fail("Invalid paper number '" + std::string(num) + "'", context);
                }
 
-               // normalize paper numbers to use uppercase
-               std::transform(paper_number.begin(), paper_number.end(), paper_number.begin(),
-                     [] (unsigned char c) { return std::toupper(c); });
-
-               auto title = paper_title_attr(paper_number, meta);
-
-               j -= i - 1;
-               std::string r = "<a href=\"https://wg21.link/" + paper_number + "\"" + title + ">" + paper_number + "</a>";
-               s.replace(i, j, r);
-               i += r.size() - 1;
-               continue;
+               // paper numbers are normalized to use uppercase
+               auto const paper_number = paper->str();
+               replace(i, j, "<a href=\"https://wg21.link/");
+               out += paper_number;
+               out += '"';
+               out += meta.paper_title_attr(paper_number);
+               out += '>';
+               out += paper_number;
+               out += "</a>";
             }
+            // else don't worry about this <tag/>
             i = j;
-            continue;  // don't worry about this <tag/>
+            continue;
          }
 
+         if (tag_stack.full()) {
+            fail("Tags nested too deeply at <" + std::string(tag) + ">", context);
+         }
          tag_stack.push_back(tag);
          if (tag == "resolution") {
-             std::ostringstream os;
-             os << "<p id=\"res-" << is.num << "\"><b>Proposed resolution:</b></p>";
-             auto r = os.str();
-             s.replace(i, j-i + 1, r);
-             i += r.length() - 1;
+             replace(i, j, "<p id=\"res-");
+             out += std::to_string(is.num);
+             out += "\"><b>Proposed resolution:</b></p>";
          }
-         else if (auto r = substitutions.find(tag); r != substitutions.end()) {
-             s.replace(i, j-i + 1, r->second.first);
-             i += r->second.first.size() - 1;
-         }
-         else if (tag == "!--") {
-             tag_stack.pop_back();
-             j = s.find("-->", i);
-             j += 3;
-             s.erase(i, j-i);
-             --i;
-         }
-         else {
-             i = j;
+         else if (auto r = find_substitution(tag)) {
+             replace(i, j, r->start);
          }
+         i = j;
       }
       if (!tag_stack.empty())
-         throw std::runtime_error("Unclosed tag <" + tag_stack.back() + "> in issue " + std::to_string(is.num));
+         throw std::runtime_error("Unclosed tag <" + std::string(tag_stack.back()) + "> in issue " + std::to_string(is.num));
+
+      out.append(src, copied);
+      s = std::move(out);
    };
 
    fix_tags(is.text);
    fix_tags(is.resolution);
+   return references;
+}
+
+void mark_duplicates(std::span<lwg::issue> issues, lwg::issue_index const & index,
+                     std::span<issue_references const> references) {
+   // Mark up each issue with the issues in its <duplicate> element, and each of those
+   // with it, replacing any duplicates that were marked up before.
+   // 'references' are the results of formatting each of the 'issues', which 'index' indexes.
+   for (auto & is : issues) {
+      is.duplicates.clear();
+   }
+   for (std::size_t i = 0; i != issues.size(); ++i) {
+      for (int num : references[i].duplicates) {
+         auto & other = issues[index.find(num) - index.issues().data()];
+         other.duplicates.insert(issues[i].anchor);
+         issues[i].duplicates.insert(other.anchor);
+      }
+   }
 }
 
 
-void prepare_issues(std::span<lwg::issue> issues, lwg::metadata & meta) {
+void prepare_issues(std::span<lwg::issue> issues, lwg::metadata const & meta, unsigned jobs) {
    // Initially sort the issues by issue number, so each issue can be correctly 'format'ted
   std::ranges::sort(issues, {}, &lwg::issue::num);
 
-   // Then we format the issues, which should be the last time we need to touch the issues themselves
-   // We may turn this into a two-stage process, analysing duplicates and then applying the links
-   // This will allow us to better express constness when the issues are used purely for reference.
-   // Currently, the 'format' function takes a span of non-const-issues purely to
-   // mark up information related to duplicates, so processing duplicates in a separate pass may
-   // clarify the code.
-   for (auto & i : issues) { format_issue_as_html(i, issues, meta); }
+   // Then we format the issues, which should be the last time we need to touch the issues themselves.
+   // Formatting an issue only modifies that issue, so up to 'jobs' issues are formatted at once.
+   // The duplicates found in each issue are marked up on both issues once they are all formatted.
+   // The anchor linking to each issue is made once, before any issue refers to it.
+   for (auto & i : issues) { i.anchor = make_html_anchor(i); }
+
+   lwg::issue_index const index{issues};
+   std::vector<issue_references> references(issues.size());
+   lwg::parallel_for(issues.size(), jobs, [&](std::size_t i) {
+      references[i] = format_issue_as_html(issues[i], index, meta);
+   });
+   mark_duplicates(issues, index, references);
 
    // Issues will be routinely re-sorted in later code, but contents should be fixed after formatting.
    // This suggests we may want to be storing some kind of issue handle in the functions that keep
@@ -516,216 +580,531 @@ auto prepare_issues_for_diff_report(std::vector<lwg::issue> const & issues) -> s
 #endif
 }
 
-struct list_issues {
-   std::vector<int> const & issues;
-};
-
+// ============================================================================================================
 
-auto operator<<( std::ostream & out, list_issues const & x) -> std::ostream & {
-   auto list_separator = "";
-   for (auto number : x.issues) {
-      out << list_separator << "<iref ref=\"" << number << "\"/>";
-      list_separator = ", ";
+void check_is_directory(fs::path const & directory) {
+   if (!is_directory(directory)) {
+      throw std::runtime_error(directory.string() + " is not an existing directory");
    }
-   return out;
 }
 
-
-struct find_num {
-   // Predicate functor useful to find issue 'y' in a mapping of issue-number -> some string.
-    bool operator()(std::tuple<int, std::string> const & x, int y) const noexcept {
-      return std::get<0>(x) < y;
+auto read_mailing_info(fs::path const & issues_path) -> lwg::mailing_info {
+   fs::path filename{issues_path / "lwg-issues.xml"};
+   std::ifstream infile{filename};
+   if (!infile.is_open()) {
+      throw std::runtime_error{"Unable to open " + filename.string()};
    }
-};
-
 
-struct discover_new_issues {
-   std::vector<std::tuple<int, std::string>> const & old_issues;
-   std::vector<std::tuple<int, std::string>> const & new_issues;
-};
+   return lwg::mailing_info{infile};
+}
 
+void make_documents(std::vector<lwg::issue> const & issues,
+                    lwg::metadata const & metadata,
+                    lwg::mailing_info const & lwg_issues_xml,
+                    std::vector<std::tuple<int, std::string>> const & old_issues,
+                    fs::path const & target_path,
+                    lwg::output_manifest * manifest,
+                    unsigned jobs) {
+   // Write all the documents for a mailing to 'target_path', from the 'issues'
+   // that have been formatted by 'prepare_issues'.
+   // If 'manifest' is not null, documents that would not change are not written.
+   // The documents are independent of each other, so up to 'jobs' are made at once.
+
+   lwg::report_generator generator{issues, lwg_issues_xml, metadata.section_db, metadata.section_links};
+   if (manifest) {
+      generator.track_changes(*manifest, issues);
+   }
 
-auto operator<<( std::ostream & out, discover_new_issues const & x) -> std::ostream & {
-   std::vector<std::tuple<int, std::string>> const & old_issues = x.old_issues;
-   std::vector<std::tuple<int, std::string>> const & new_issues = x.new_issues;
+   // issues must be sorted by number before making the mailing list documents
+   assert(std::ranges::is_sorted(issues, {}, &lwg::issue::num));
 
-   struct status_order {
-      // predicate for 'map'
+   // Collect a report on all issues that have changed status
+   // This will be added to the revision history of the 3 standard documents
+   auto const new_issues = prepare_issues_for_diff_report(issues);
 
-      using status_string = std::string;
-      auto operator()(status_string const & x, status_string const & y) const noexcept -> bool {
-         return lwg::get_status_priority(x) < lwg::get_status_priority(y);
-      }
-   };
+   std::ostringstream os_diff_report;
+   lwg::print_status_diff_html(os_diff_report, old_issues, new_issues );
+   auto const diff_report = os_diff_report.str();
 
-   std::map<std::string, std::vector<int>, status_order> added_issues;
-   for (auto const & i : new_issues) {
-      auto j = std::lower_bound(old_issues.cbegin(), old_issues.cend(), std::get<0>(i), find_num{});
-      if (j == old_issues.end() or std::get<0>(*j) != std::get<0>(i)) {
-         added_issues[std::get<1>(i)].push_back(std::get<0>(i));
-      }
-   }
+   // The index documents each sort their own copy of these pointers, so they never reorder 'issues'.
+   std::vector<lwg::issue const *> all_issues;
+   std::vector<lwg::issue const *> unresolved_issues;
+   std::vector<lwg::issue const *> votable_issues;
 
-   for (auto const & i : added_issues) {
-      auto const item_count = std::get<1>(i).size();
-      if (1 == item_count) {
-         out << "<li>Added the following " << std::get<0>(i) << " issue: <iref ref=\"" << std::get<1>(i).front() << "\"/>.</li>\n";
+   for (auto const & iss : issues) {
+      all_issues.push_back(&iss);
+      if (lwg::is_not_resolved(iss.stat)) {
+         unresolved_issues.push_back(&iss);
       }
-      else {
-         out << "<li>Added the following " << item_count << " " << std::get<0>(i) << " issues: " << list_issues{std::get<1>(i)} << ".</li>\n";
+      if (lwg::is_votable(iss.stat)) {
+         votable_issues.push_back(&iss);
       }
    }
 
-   if (added_issues.empty()) {
-      out << "<li>No issues added.</li>\n";
+   // If votable list is empty, we are between meetings and should list Ready issues instead
+   // Otherwise, issues moved to Ready during a meeting will remain 'unresolved' by that meeting
+   auto & ready_issues = votable_issues.empty() ? votable_issues : unresolved_issues;
+   for (auto const & iss : issues) {
+      if (lwg::is_ready(iss.stat)) {
+         ready_issues.push_back(&iss);
+      }
    }
 
-   return out;
-}
+   std::vector<std::function<std::unique_ptr<lwg::issue_list_document>()>> issue_lists = {
+      // First generate the primary 3 standard issues lists
+      [&] { return generator.start_active(issues, target_path, diff_report); },
+      [&] { return generator.start_defect(issues, target_path, diff_report); },
+      [&] { return generator.start_closed(issues, target_path, diff_report); },
 
+      // unofficial documents
+      [&] { return generator.start_tentative (issues, target_path); },
+      [&] { return generator.start_unresolved(issues, target_path); },
+      [&] { return generator.start_immediate (issues, target_path); },
+      [&] { return generator.start_ready     (issues, target_path); },
+   };
 
-struct discover_changed_issues {
-   std::vector<std::tuple<int, std::string>> const & old_issues;
-   std::vector<std::tuple<int, std::string>> const & new_issues;
-};
+   // The documents that show the issues in full are the biggest, so printing their issues
+   // is split into chunks, which are run as separate tasks alongside the other documents.
+   // Each of these documents is written by the task that prints its last chunk.
+   std::vector<std::unique_ptr<lwg::issue_list_document>> started(issue_lists.size());
+   lwg::parallel_for(issue_lists.size(), jobs, [&](std::size_t i) { started[i] = issue_lists[i](); });
+
+   std::vector<std::function<void()>> tasks;
+   for (auto const & doc : started) {
+      for (std::size_t c = 0; doc and c != doc->chunks(); ++c) {
+         tasks.push_back([&generator, doc = doc.get(), c] {
+            if (doc->print_chunk(c)) {
+               generator.finish(*doc);
+            }
+         });
+      }
+   }
 
+   tasks.insert(tasks.end(), {
+      // [&] { generator.make_editors_issues(issues, target_path); },
 
-auto operator << (std::ostream & out, discover_changed_issues x) -> std::ostream & {
-   std::vector<std::tuple<int, std::string>> const & old_issues = x.old_issues;
-   std::vector<std::tuple<int, std::string>> const & new_issues = x.new_issues;
+      // Now we have a parsed and formatted set of issues, we can write the standard set of HTML documents
+      [&] { generator.make_sort_by_num            (all_issues, {target_path / "lwg-toc.html"}); },
+      [&] { lwg::write_status_snapshot(target_path / "lwg-toc.txt", new_issues); },
+      [&] { generator.make_sort_by_status         (all_issues, {target_path / "lwg-status.html"}); },
+      [&] { generator.make_sort_by_status_mod_date(all_issues, {target_path / "lwg-status-date.html"}); },
+      [&] { generator.make_sort_by_section        (all_issues, {target_path / "lwg-index.html"}); },
 
-   struct status_transition_order {
-      using status_string = std::string;
-      using from_status_to_status = std::tuple<status_string, status_string>;
+      // Note that this additional document is very similar to unresolved-index.html below
+      [&] { generator.make_sort_by_section        (all_issues, {target_path / "lwg-index-open.html"}, true); },
 
-      auto operator()(from_status_to_status const & x, from_status_to_status const & y) const noexcept -> bool {
-         auto const xp2 = lwg::get_status_priority(std::get<1>(x));
-         auto const yp2 = lwg::get_status_priority(std::get<1>(y));
-         return xp2 < yp2  or  (!(yp2 < xp2)  and  lwg::get_status_priority(std::get<0>(x)) < lwg::get_status_priority(std::get<0>(y)));
-      }
-   };
+      // Make a similar set of index documents for the issues that are 'live' during a meeting
+      // Note that these documents want to reference each other, rather than lwg- equivalents,
+      // although it may not be worth attempting fix-ups as the per-issue level
+      // During meetings, it would be good to list newly-Ready issues here
+      [&] { generator.make_sort_by_num            (unresolved_issues, {target_path / "unresolved-toc.html"}); },
+      [&] { generator.make_sort_by_status         (unresolved_issues, {target_path / "unresolved-status.html"}); },
+      [&] { generator.make_sort_by_status_mod_date(unresolved_issues, {target_path / "unresolved-status-date.html"}); },
+      [&] { generator.make_sort_by_section        (unresolved_issues, {target_path / "unresolved-index.html"}); },
+      [&] { generator.make_sort_by_priority       (unresolved_issues, {target_path / "unresolved-prioritized.html"}); },
 
-   std::map<std::tuple<std::string, std::string>, std::vector<int>, status_transition_order> changed_issues;
-   for (auto const & i : new_issues) {
-      auto j = std::lower_bound(old_issues.begin(), old_issues.end(), std::get<0>(i), find_num{});
-      if (j != old_issues.end()  and  std::get<0>(i) == std::get<0>(*j)  and  std::get<1>(*j) != std::get<1>(i)) {
-         changed_issues[std::tuple<std::string, std::string>{std::get<1>(*j), std::get<1>(i)}].push_back(std::get<0>(i));
-      }
+      // Make another set of index documents for the issues that are up for a vote during a meeting
+      // Note that these documents want to reference each other, rather than lwg- equivalents,
+      // although it may not be worth attempting fix-ups as the per-issue level
+      // Between meetings, it would be good to list Ready issues here
+      [&] { generator.make_sort_by_num            (votable_issues, {target_path / "votable-toc.html"}); },
+      [&] { generator.make_sort_by_status         (votable_issues, {target_path / "votable-status.html"}); },
+      [&] { generator.make_sort_by_status_mod_date(votable_issues, {target_path / "votable-status-date.html"}); },
+      [&] { generator.make_sort_by_section        (votable_issues, {target_path / "votable-index.html"}); },
+   });
+
+   // There is one file for each issue, which is more work than any other document,
+   // so split them into smaller tasks that can run alongside the others.
+   constexpr std::size_t issues_per_task = 512;
+   for (std::size_t i = 0; i < issues.size(); i += issues_per_task) {
+      auto const some_issues = std::span(issues).subspan(i, std::min(issues_per_task, issues.size() - i));
+      tasks.push_back([&, some_issues] { generator.make_individual_issues(some_issues, target_path); });
    }
 
-   for (auto const & i : changed_issues) {
-      auto const item_count = std::get<1>(i).size();
-      if (1 == item_count) {
-         out << "<li>Changed the following issue to " << std::get<1>(std::get<0>(i))
-             << " (from " << std::get<0>(std::get<0>(i)) << "): <iref ref=\"" << std::get<1>(i).front() << "\"/>.</li>\n";
-      }
-      else {
-         out << "<li>Changed the following " << item_count << " issues to " << std::get<1>(std::get<0>(i))
-             << " (from " << std::get<0>(std::get<0>(i)) << "): " << list_issues{std::get<1>(i)} << ".</li>\n";
-      }
-   }
+   lwg::parallel_for(tasks.size(), jobs, [&](std::size_t i) { tasks[i](); });
+}
 
-   if (changed_issues.empty()) {
-      out << "<li>No issues changed.</li>\n";
-   }
+auto issue_cache_fingerprint(fs::path const & meta_path, fs::path const & program) -> std::uint64_t {
+   // The cached issues depend on the metadata they were parsed with, and on the
+   // program that parsed them.
+   return lwg::metadata_fingerprint(meta_path) ^ lwg::program_fingerprint(program);
+}
 
-   return out;
+auto lwg_issues_xml_fingerprint(fs::path const & issues_path) -> std::uint64_t {
+   return lwg::hash_bytes(lwg::read_file_into_string(issues_path / "lwg-issues.xml"));
 }
 
+#ifdef LWG_HAVE_INOTIFY
+// Closes an inotify instance (or any other file descriptor) when it goes out of scope.
+struct file_descriptor {
+   explicit file_descriptor(int fd) : fd(fd) { }
+   file_descriptor(file_descriptor const &) = delete;
+   file_descriptor & operator=(file_descriptor const &) = delete;
+   ~file_descriptor() { if (fd >= 0) ::close(fd); }
+   int fd;
+};
 
-auto count_issues(std::span<const std::tuple<int, std::string>> issues) -> std::tuple<int, int, int> {
-   int n_open = 0;
-   int n_reassigned = 0;
-   int n_closed = 0;
+// The issues as formatted by 'prepare_issues', kept between the builds in watch mode,
+// so that each build only formats the issues that have changed, and the issues whose
+// links to them have changed, instead of every issue.
+class prepared_issues {
+public:
+   void update(std::map<fs::path, lwg::issue> const & parsed, std::set<int> const & changed,
+               lwg::metadata const & meta, unsigned jobs);
+     // Make the issues the 'parsed' issues, formatted using 'meta', in which their
+     // sections must be registered. Only the issues numbered in 'changed' need to be
+     // formatted, as well as any that refer to them, unless 'meta' has different
+     // sections, or 'clear' has been called, since the last update.
+     // If formatting fails this throws, and the next update formats every issue.
+
+   void clear() noexcept { m_valid = false; }
+     // Format every issue on the next update, e.g. because the metadata has changed.
+
+   auto issues() const noexcept -> std::vector<lwg::issue> const & { return m_issues; }
+     // The formatted issues, sorted by number.
+
+   auto formatted() const noexcept -> std::size_t { return m_formatted; }
+     // The number of issues formatted by the last update.
+
+private:
+   std::vector<lwg::issue>       m_issues;
+   std::vector<issue_references> m_references;   // the result of formatting each of 'm_issues'
+   lwg::section_map              m_sections;     // the sections that 'm_issues' were formatted with
+   std::size_t                   m_formatted = 0;
+   bool                          m_valid = false;
+};
 
-   for(auto const & elem : issues) {
-      if (lwg::is_assigned_to_another_group(std::get<1>(elem))) {
-      	++n_reassigned;
+void prepared_issues::update(std::map<fs::path, lwg::issue> const & parsed, std::set<int> const & changed,
+                             lwg::metadata const & meta, unsigned jobs) {
+   bool const all = !m_valid or meta.section_db != m_sections;
+   m_valid = false;
+
+   // An issue that refers to a changed issue shows its title and status in the link
+   // to it, so it must be formatted again if the link changes, or the issue is removed.
+   std::set<int> outdated(changed.begin(), changed.end());
+   if (!all) {
+      auto find_old = [this](int num) -> lwg::issue const * {
+         auto i = std::ranges::lower_bound(m_issues, num, {}, &lwg::issue::num);
+         return i != m_issues.end() and i->num == num ? &*i : nullptr;
+      };
+      std::set<int> relinked;
+      for (int num : changed) {
+         if (find_old(num)) {
+            relinked.insert(num);
+         }
       }
-      else if (lwg::is_active(std::get<1>(elem))) {
-         ++n_open;
+      for (auto const & [file, is] : parsed) {
+         if (relinked.contains(is.num) and find_old(is.num)->anchor == lwg::make_html_anchor(is)) {
+            relinked.erase(is.num);
+         }
       }
-      else {
-         ++n_closed;
+      for (std::size_t i = 0; i != m_issues.size(); ++i) {
+         auto const & refs = m_references[i];
+         auto refers = [&](int num) { return relinked.contains(num); };
+         if (std::ranges::any_of(refs.irefs, refers) or std::ranges::any_of(refs.duplicates, refers)) {
+            outdated.insert(m_issues[i].num);
+         }
       }
    }
-   return {n_open, n_reassigned, n_closed};
-}
-
 
-struct write_summary {
-   std::vector<std::tuple<int, std::string>> const & old_issues;
-   std::vector<std::tuple<int, std::string>> const & new_issues;
-};
+   // Reuse the formatted issues that are not outdated, and copy the others to be formatted again.
+   struct entry {
+      lwg::issue       issue;
+      issue_references references;
+      bool             format;
+   };
+   std::vector<entry> entries;
+   entries.reserve(parsed.size());
+   std::vector<char> reused(m_issues.size());
+   for (auto const & [file, is] : parsed) {
+      auto const old = std::ranges::lower_bound(m_issues, is.num, {}, &lwg::issue::num) - m_issues.begin();
+      auto const pos = static_cast<std::size_t>(old);
+      if (all or outdated.contains(is.num) or pos == m_issues.size() or m_issues[pos].num != is.num or reused[pos]) {
+         entries.push_back({is, {}, true});
+      }
+      else {
+         reused[pos] = true;
+         entries.push_back({std::move(m_issues[pos]), std::move(m_references[pos]), false});
+      }
+   }
+   std::ranges::sort(entries, {}, [](entry const & e) { return e.issue.num; });
+
+   m_issues.clear();
+   m_references.clear();
+   std::vector<std::size_t> to_format;
+   for (auto & e : entries) {
+      if (e.format) {
+         e.issue.anchor = make_html_anchor(e.issue);
+         to_format.push_back(m_issues.size());
+      }
+      m_issues.push_back(std::move(e.issue));
+      m_references.push_back(std::move(e.references));
+   }
 
+   lwg::issue_index const index{m_issues};
+   lwg::parallel_for(to_format.size(), jobs, [&](std::size_t i) {
+      auto const pos = to_format[i];
+      m_references[pos] = format_issue_as_html(m_issues[pos], index, meta);
+   });
+   mark_duplicates(m_issues, index, m_references);
 
-auto operator << (std::ostream & out, write_summary const & x) -> std::ostream & {
+   m_sections = meta.section_db;
+   m_formatted = to_format.size();
+   m_valid = true;
+}
 
-   auto [n_open_old, n_reassigned_old, n_closed_old] = count_issues(x.old_issues);
-   auto [n_open_new, n_reassigned_new, n_closed_new] = count_issues(x.new_issues);
+void watch_for_changes(fs::path const & path, unsigned jobs, bool use_cache, fs::path const & program) {
+   // Generate the documents, then wait for files in the xml and meta-data directories
+   // to change, and regenerate the documents that are affected, until interrupted.
+   //
+   // Everything the documents are generated from is kept in memory between builds,
+   // so only the issue files that have changed are parsed again, and only those
+   // issues, and the issues that link to them, are formatted again. A change to the
+   // metadata reloads everything, and a change to lwg-issues.xml rewrites every
+   // document, because they all show the revision number.
+   //
+   // Errors are reported, but do not stop the program, so that a mistake in an
+   // issue can be fixed while the lists are being watched.
+   //
+   // Note that the revision timestamp shown in the documents is the time the program started.
+   //
+   // If 'use_cache' is true the issues are first read using the cache in mailing/.cache,
+   // and 'program' is the path to this program, as in 'argv[0]'.
+
+   auto const issues_path = path / "xml";
+   auto const meta_path = path / "meta-data";
+   auto const target_path = path / "mailing";
+   auto const cache_file = target_path / ".cache" / "issues.cache";
+   auto const manifest_file = target_path / ".cache" / "outputs.manifest";
+
+   file_descriptor inotify{::inotify_init1(IN_CLOEXEC)};
+   if (inotify.fd < 0) {
+      throw std::runtime_error{"Unable to watch for changes: inotify_init1 failed"};
+   }
+   constexpr std::uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+   int const xml_watch = ::inotify_add_watch(inotify.fd, issues_path.c_str(), mask);
+   int const meta_watch = ::inotify_add_watch(inotify.fd, meta_path.c_str(), mask);
+   if (xml_watch < 0 or meta_watch < 0) {
+      throw std::runtime_error{"Unable to watch for changes in " + path.string()};
+   }
 
-   auto write_change = [&out](int n_new, int n_old){
-      out << (n_new >= n_old ? "up by " : "down by ")
-          << std::abs(n_new - n_old);
+   lwg::metadata metadata;
+   std::vector<std::tuple<int, std::string>> old_issues;
+   std::optional<lwg::mailing_info> lwg_issues_xml;
+   std::optional<lwg::output_manifest> manifest;
+   std::map<fs::path, lwg::issue> issues;   // as parsed, before 'prepare_issues'
+   std::set<fs::path> broken;               // files that could not be parsed
+   prepared_issues prepared;
+   std::set<int> outdated;                  // issues that have changed since 'prepared' was updated
+
+   bool reload_all = true;
+   bool reload_mailing_info = true;
+   std::set<fs::path> changed;
+
+   auto parse_file = [&](fs::path const & file) {
+      broken.erase(file);
+      if (auto old = issues.find(file); old != issues.end()) {
+         outdated.insert(old->second.num);
+         issues.erase(old);
+      }
+      if (fs::exists(file)) {
+         try {
+            // The file is read rather than mapped, as it may be saved again while it is parsed.
+            auto is = parse_issue_from_file(lwg::read_file_into_string(file), file.string(), metadata, std::cerr);
+            outdated.insert(is.num);
+            issues.emplace(file, std::move(is));
+         }
+         catch (std::exception const & ex) {
+            std::cout << ex.what() << std::endl;
+            broken.insert(file);
+         }
+      }
    };
 
-   out << "<li>" << n_open_new << " open issues, ";
-   write_change(n_open_new, n_open_old);
-   out << ".</li>\n";
-
-   out << "<li>" << n_closed_new << " closed issues, ";
-   write_change(n_closed_new, n_closed_old);
-   out << ".</li>\n";
+   // Block until at least one relevant file has changed, then wait until
+   // there have been no more changes for a short time, so that a command which
+   // modifies several files only causes one rebuild.
+   auto wait_for_changes = [&] {
+      alignas(inotify_event) char buf[4096];
+      bool relevant = false;
+      for (;;) {
+         pollfd p{inotify.fd, POLLIN, 0};
+         int n = ::poll(&p, 1, relevant ? 100 : -1);
+         if (n < 0 and errno == EINTR) {
+            continue;
+         }
+         if (n < 0) {
+            throw std::runtime_error{"Unable to watch for changes: poll failed"};
+         }
+         if (n == 0) {
+            return;
+         }
 
-   out << "<li>" << n_reassigned_new << " reassigned issues, ";
-   write_change(n_reassigned_new, n_reassigned_old);
-   out << ".</li>\n";
+         auto len = ::read(inotify.fd, buf, sizeof buf);
+         if (len <= 0) {
+            throw std::runtime_error{"Unable to watch for changes: read failed"};
+         }
+         for (char const * e = buf; e < buf + len; ) {
+            auto const & event = *reinterpret_cast<inotify_event const *>(e);
+            e += sizeof(inotify_event) + event.len;
 
-   int n_total_new = n_open_new + n_reassigned_new + n_closed_new;
-   int n_total_old = n_open_old + n_reassigned_old + n_closed_old;
-   out << "<li>" << n_total_new << " issues total, ";
-   write_change(n_total_new, n_total_old);
-   out << ".</li>\n";
+            if (event.mask & IN_Q_OVERFLOW) {
+               // Some events were lost, so anything could have changed.
+               reload_all = relevant = true;
+               continue;
+            }
+            if (event.len == 0) {
+               continue;
+            }
+            std::string_view name = event.name;
+            if (event.wd == meta_watch) {
+               if (name == "section.data" or name == "dates" or name == "paper_titles.txt" or name == "lwg-toc.old.html" or name == "lwg-toc.old.txt") {
+                  reload_all = relevant = true;
+               }
+            }
+            else if (name == "lwg-issues.xml") {
+               reload_mailing_info = relevant = true;
+            }
+            else if (name.starts_with("issue") and name.ends_with(".xml")) {
+               changed.insert(issues_path / name);
+               relevant = true;
+            }
+         }
+      }
+   };
 
-   return out;
-}
+   for (;;) {
+      try {
+         auto const start = std::chrono::steady_clock::now();
+
+         if (reload_all) {
+            std::cout << "Reading issues from: " << issues_path << std::endl;
+            metadata = lwg::metadata::read_from_path(path, false);
+            old_issues = read_old_issues(meta_path);
+            std::optional<lwg::issue_cache> cache;
+            if (use_cache) {
+               cache = lwg::issue_cache::load(cache_file, issue_cache_fingerprint(meta_path, program));
+            }
+            auto const files = lwg::issue_files(issues_path);
+            auto parsed = read_issues(files, metadata, jobs, cache ? &*cache : nullptr, true);
+            issues.clear();
+            broken.clear();
+            for (std::size_t i = 0; i != files.size(); ++i) {
+               issues.emplace(files[i], std::move(parsed[i]));
+            }
+            if (cache && cache->modified()) {
+               try {
+                  cache->save(cache_file);
+               }
+               catch (std::exception const & ex) {
+                  // The cache only saves time, so failing to update it is not an error.
+                  std::cerr << "warning: " << ex.what() << '\n';
+               }
+            }
+            prepared.clear();
+            reload_all = false;
+         }
+         else {
+            for (auto const & file : changed) {
+               std::cout << "Reading " << file.filename() << std::endl;
+               parse_file(file);
+            }
+         }
+         changed.clear();
 
+         if (reload_mailing_info) {
+            lwg_issues_xml = read_mailing_info(issues_path);
+            manifest = lwg::output_manifest::load(manifest_file, lwg_issues_xml_fingerprint(issues_path));
+            reload_mailing_info = false;
+         }
 
-void print_current_revisions( std::ostream & out
-                            , std::vector<std::tuple<int, std::string>> const & old_issues
-                            , std::vector<std::tuple<int, std::string>> const & new_issues
-                            ) {
-   out << "<ul>\n"
-          "<li><b>Summary:</b><ul>\n"
-       << write_summary{old_issues, new_issues}
-       << "</ul></li>\n"
-          "<li><b>Details:</b><ul>\n"
-       << discover_new_issues{old_issues, new_issues}
-       << discover_changed_issues{old_issues, new_issues}
-       << "</ul></li>\n"
-          "</ul>\n";
-}
+         if (broken.empty()) {
+            // Build the section index from scratch, so it does not keep
+            // sections only referred to by old versions of the issues.
+            std::vector<lwg::issue const *> parsed;
+            for (auto const & elem : issues) {
+               parsed.push_back(&elem.second);
+            }
+            auto meta = metadata;
+            register_sections(std::move(parsed), meta);
+            prepared.update(issues, outdated, meta, jobs);
+            outdated.clear();
+
+            auto const updated = manifest->updated();
+            make_documents(prepared.issues(), meta, *lwg_issues_xml, old_issues, target_path, &*manifest, jobs);
+            try {
+               manifest->save(manifest_file);
+            }
+            catch (std::exception const & ex) {
+               // The manifest in memory is still used by the next build, so only
+               // the next run of this program has to write every document again.
+               std::cerr << "warning: " << ex.what() << '\n';
+            }
 
-// ============================================================================================================
+            auto const ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            std::cout << "Formatted " << prepared.formatted() << " issues and wrote " << manifest->updated() - updated
+                      << " documents in " << ms.count() << "ms" << std::endl;
+         }
+         else {
+            std::cout << "Not writing any documents until " << broken.size() << " issue file(s) are fixed" << std::endl;
+         }
+      }
+      catch (std::exception const & ex) {
+         std::cout << ex.what() << std::endl;
+      }
 
-void check_is_directory(fs::path const & directory) {
-   if (!is_directory(directory)) {
-      throw std::runtime_error(directory.string() + " is not an existing directory");
+      std::cout << "Watching for changes..." << std::endl;
+      wait_for_changes();
    }
 }
-
+#endif
 int main(int argc, char* argv[]) {
    try {
       fs::path path;
       bool revhist = false;
+      unsigned jobs = lwg::jobs_from_environment();
+      bool use_cache = false;
+      bool incremental = false;
+      bool watch = false;
+
+      // Options must come before any other arguments, e.g. "lists -j 8 revision history".
+      // "-j N" parses the issues using N threads, "-j 0" uses one thread per core.
+      // The LWG_JOBS environment variable sets the default number of threads.
+      // "--cache" saves the parsed issues in mailing/.cache, and reuses them
+      // in later runs for the files that have not changed, instead of parsing
+      // every issue. The cache is about 15 MB, so it is not written by default.
+      // "--incremental" only rewrites the documents that would be changed.
+      // "--watch" makes the documents incrementally, then waits for files to
+      // change and updates the documents again, until interrupted.
+      std::vector<std::string_view> args(argv + 1, argv + argc);
+      while (!args.empty() && args.front().starts_with("-")) {
+         std::string_view opt = args.front();
+         args.erase(args.begin());
+         if (opt == "--cache") {
+            use_cache = true;
+         }
+         else if (opt == "--incremental") {
+            incremental = true;
+         }
+         else if (opt == "--watch") {
+            watch = true;
+         }
+         else if (opt.starts_with("-j")) {
+            jobs = lwg::parse_jobs_option(opt, args);
+         }
+         else {
+            throw std::runtime_error{"Unknown option " + std::string(opt)};
+         }
+      }
+
       std::cout << "Preparing new LWG issues lists..." << std::endl;
-      if (argc == 2) {
-         path = argv[1];
+      if (args.size() == 1) {
+         path = args[0];
       }
       else {
          path = fs::current_path();
 
-         if (argc == 3 && std::string(argv[1]) == "revision" && std::string(argv[2]) == "history")
+         if (args.size() == 2 && args[0] == "revision" && args[1] == "history")
             revhist = true;
       }
 
@@ -734,6 +1113,31 @@ int main(int argc, char* argv[]) {
       const fs::path target_path{path / "mailing"};
       check_is_directory(target_path);
 
+      if (watch) {
+#ifdef LWG_HAVE_INOTIFY
+         watch_for_changes(path, jobs, use_cache, argv[0]);
+#else
+         throw std::runtime_error{"--watch is not supported on this platform"};
+#endif
+      }
+
+      if (revhist) {
+         // The revision history only needs the number and status of each issue,
+         // so only the <issue> start tags are read, and nothing is formatted.
+         auto const issues_path = path / "xml";
+         lwg::mailing_info lwg_issues_xml = read_mailing_info(issues_path);
+         auto const old_issues = read_old_issues(path / "meta-data");
+
+         std::cout << "Reading issues from: " << issues_path << std::endl;
+         auto const new_issues = read_issue_headers(lwg::issue_files(issues_path), jobs);
+
+         std::cout << "\n<revision tag=\"" << lwg_issues_xml.get_revision() << "\">\n"
+            << lwg_issues_xml.get_date()  << ' ' << lwg_issues_xml.get_title() << '\n';
+         lwg::print_status_diff_html(std::cout, old_issues, new_issues);
+         std::cout << "</revision>\n";
+         return 0;
+      }
+
       auto metadata = lwg::metadata::read_from_path(path);
 #if defined (DEBUG_LOGGING)
       // dump the contents of the section index
@@ -745,107 +1149,47 @@ int main(int argc, char* argv[]) {
       }
 #endif
 
-      auto const old_issues = read_issues_from_toc(read_file_into_string(path / "meta-data" / "lwg-toc.old.html"));
+      auto const old_issues = read_old_issues(path / "meta-data");
 
       auto const issues_path = path / "xml";
 
-      lwg::mailing_info lwg_issues_xml = [&issues_path](){
-         fs::path filename{issues_path / "lwg-issues.xml"};
-         std::ifstream infile{filename};
-         if (!infile.is_open()) {
-            throw std::runtime_error{"Unable to open " + filename.string()};
-         }
-
-         return lwg::mailing_info{infile};
-      }();
-
-      //lwg::mailing_info lwg_issues_xml{issues_path};
-
+      lwg::mailing_info lwg_issues_xml = read_mailing_info(issues_path);
 
       std::cout << "Reading issues from: " << issues_path << std::endl;
-      auto issues = read_issues(issues_path, metadata);
-      prepare_issues(issues, metadata);
-
-
-      lwg::report_generator generator{lwg_issues_xml, metadata.section_db};
-
-
-      // issues must be sorted by number before making the mailing list documents
-      // std::ranges::sort(issues, {}, &lwg::issue::num);
-
-      // Collect a report on all issues that have changed status
-      // This will be added to the revision history of the 3 standard documents
-      auto const new_issues = prepare_issues_for_diff_report(issues);
-
-      if (revhist) {
-         std::cout << "\n<revision tag=\"" << lwg_issues_xml.get_revision() << "\">\n"
-            << lwg_issues_xml.get_date()  << ' ' << lwg_issues_xml.get_title() << '\n';
-         print_current_revisions(std::cout, old_issues, new_issues);
-         std::cout << "</revision>\n";
-         return 0;
+      auto const cache_file = target_path / ".cache" / "issues.cache";
+      std::optional<lwg::issue_cache> cache;
+      if (use_cache) {
+         cache = lwg::issue_cache::load(cache_file, issue_cache_fingerprint(path / "meta-data", argv[0]));
+      }
+      auto issues = read_issues(lwg::issue_files(issues_path), metadata, jobs, cache ? &*cache : nullptr);
+      if (cache && cache->modified()) {
+         try {
+            cache->save(cache_file);
+         }
+         catch (std::exception const & ex) {
+            // The cache only saves time, so failing to update it is not an error.
+            std::cerr << "warning: " << ex.what() << '\n';
+         }
+      }
+      register_sections(issues, metadata);
+      prepare_issues(issues, metadata, jobs);
+
+      // In incremental mode, documents that have not changed since the last run are not written.
+      // Every document shows the revision from lwg-issues.xml, so any change to that file
+      // means that everything is regenerated.
+      auto const manifest_file = target_path / ".cache" / "outputs.manifest";
+      std::optional<lwg::output_manifest> manifest;
+      if (incremental) {
+         manifest = lwg::output_manifest::load(manifest_file, lwg_issues_xml_fingerprint(issues_path));
       }
 
-      std::ostringstream os_diff_report;
-      print_current_revisions(os_diff_report, old_issues, new_issues );
-      auto const diff_report = os_diff_report.str();
-
-      std::vector<lwg::issue> unresolved_issues;
-      std::vector<lwg::issue> votable_issues;
-
-      std::copy_if(issues.begin(), issues.end(), std::back_inserter(unresolved_issues), [](lwg::issue const & iss){ return lwg::is_not_resolved(iss.stat); } );
-      std::copy_if(issues.begin(), issues.end(), std::back_inserter(votable_issues),    [](lwg::issue const & iss){ return lwg::is_votable(iss.stat); } );
-
-      // If votable list is empty, we are between meetings and should list Ready issues instead
-      // Otherwise, issues moved to Ready during a meeting will remain 'unresolved' by that meeting
-      auto ready_inserter = votable_issues.empty()
-                          ? std::back_inserter(votable_issues)
-                          : std::back_inserter(unresolved_issues);
-      std::copy_if(issues.begin(), issues.end(), ready_inserter, [](lwg::issue const & iss){ return lwg::is_ready(iss.stat); } );
-
-      // First generate the primary 3 standard issues lists
-      generator.make_active(issues, target_path, diff_report);
-      generator.make_defect(issues, target_path, diff_report);
-      generator.make_closed(issues, target_path, diff_report);
-
-      // unofficial documents
-      generator.make_tentative (issues, target_path);
-      generator.make_unresolved(issues, target_path);
-      generator.make_immediate (issues, target_path);
-      generator.make_ready     (issues, target_path);
-      // generator.make_editors_issues(issues, target_path);
-      generator.make_individual_issues(issues, target_path);
-
-
-
-      // Now we have a parsed and formatted set of issues, we can write the standard set of HTML documents
-      // Note that each of these functions is going to re-sort the 'issues' vector for its own purposes
-      generator.make_sort_by_num            (issues, {target_path / "lwg-toc.html"});
-      generator.make_sort_by_status         (issues, {target_path / "lwg-status.html"});
-      generator.make_sort_by_status_mod_date(issues, {target_path / "lwg-status-date.html"});
-      generator.make_sort_by_section        (issues, {target_path / "lwg-index.html"});
-
-      // Note that this additional document is very similar to unresolved-index.html below
-      generator.make_sort_by_section        (issues, {target_path / "lwg-index-open.html"}, true);
-
-      // Make a similar set of index documents for the issues that are 'live' during a meeting
-      // Note that these documents want to reference each other, rather than lwg- equivalents,
-      // although it may not be worth attempting fix-ups as the per-issue level
-      // During meetings, it would be good to list newly-Ready issues here
-      generator.make_sort_by_num            (unresolved_issues, {target_path / "unresolved-toc.html"});
-      generator.make_sort_by_status         (unresolved_issues, {target_path / "unresolved-status.html"});
-      generator.make_sort_by_status_mod_date(unresolved_issues, {target_path / "unresolved-status-date.html"});
-      generator.make_sort_by_section        (unresolved_issues, {target_path / "unresolved-index.html"});
-      generator.make_sort_by_priority       (unresolved_issues, {target_path / "unresolved-prioritized.html"});
-
-      // Make another set of index documents for the issues that are up for a vote during a meeting
-      // Note that these documents want to reference each other, rather than lwg- equivalents,
-      // although it may not be worth attempting fix-ups as the per-issue level
-      // Between meetings, it would be good to list Ready issues here
-      generator.make_sort_by_num            (votable_issues, {target_path / "votable-toc.html"});
-      generator.make_sort_by_status         (votable_issues, {target_path / "votable-status.html"});
-      generator.make_sort_by_status_mod_date(votable_issues, {target_path / "votable-status-date.html"});
-      generator.make_sort_by_section        (votable_issues, {target_path / "votable-index.html"});
+      make_documents(issues, metadata, lwg_issues_xml, old_issues, target_path, manifest ? &*manifest : nullptr, jobs);
 
+      if (manifest) {
+         manifest->save(manifest_file);
+         std::cout << "Wrote " << manifest->updated() << " documents, "
+                   << manifest->unchanged() << " were unchanged\n";
+      }
       std::cout << "Made all documents\n";
    }
    catch(std::exception const & ex) {
@@ -19,13 +19,19 @@
 
 namespace {
 
-void replace_all_irefs(std::span<const lwg::issue> issues, std::string & s) {
+void replace_all_irefs(lwg::issue_index const & issues, std::string & s) {
    // Replace all tagged "issues references" in string 's' with an HTML anchor-link to the live issue
    // in its appropriate issue list, as determined by the issue's status.
    // Format of an issue reference: <iref ref="ISS"/>
    // Format of anchor: <a href="lwg-INDEX.html#ISS">ISS</a>
-
-   for (auto i = s.find("<iref ref=\""); i != std::string::npos; i = s.find("<iref ref=\"")) {
+   //
+   // The result is appended to a new string, rather than replacing each reference
+   // in place, so the cost is linear in the size of 's'. The revision history has
+   // thousands of references, so this matters.
+
+   std::string out;
+   std::size_t copied = 0;
+   for (auto i = s.find("<iref ref=\""); i != std::string::npos; i = s.find("<iref ref=\"", copied)) {
       auto j = s.find('>', i);
       if (j == std::string::npos) {
          throw std::runtime_error{"missing '>' after iref"};
@@ -50,16 +56,17 @@ void replace_all_irefs(std::span<const lwg::issue> issues, std::string & s) {
          throw std::runtime_error{"bad number in iref: " + s.substr(k, l-k) };
       }
 
-      auto n = std::ranges::lower_bound(issues, num, {}, &lwg::issue::num);
-      if (n == issues.end() || n->num != num) {
+      auto n = issues.find(num);
+      if (!n) {
          throw std::runtime_error{std::format("couldn't find issue number in <iref>: {}", num)};
       }
 
-      std::string r{make_html_anchor(*n)};
-      j -= i - 1;
-      s.replace(i, j, r);
-      // i += r.size() - 1;  // unused, copy/paste from elsewhere?
+      out.append(s, copied, i - copied);
+      out += n->anchor;
+      copied = j + 1;
    }
+   out.append(s, copied);
+   s = std::move(out);
 }
 
 } // close unnamed namespace
@@ -183,7 +190,7 @@ auto mailing_info::get_revisions(std::span<const issue> issues, std::string cons
    }
    r += "</ul>\n";
 
-   replace_all_irefs(issues, r);
+   replace_all_irefs(lwg::issue_index{issues}, r);
 
    return r;
 }
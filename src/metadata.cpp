@@ -6,6 +6,7 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "metadata.h"
+#include "html_utils.h"
 
 #include <fstream>
 #include <iterator>
@@ -27,13 +28,20 @@ namespace {
         return times;
     }
 
-    auto read_paper_titles(std::filesystem::path const& path) -> std::unordered_map<std::string, std::string> {
-        std::unordered_map<std::string, std::string> titles;
+    auto read_paper_title_attrs(std::filesystem::path const& path) -> decltype(lwg::metadata::paper_title_attrs) {
+        decltype(lwg::metadata::paper_title_attrs) attrs;
         std::ifstream in{path};
         std::string paper_number, title;
-        while (in >> paper_number && std::getline(in, title))
-        titles[paper_number] = title;
-        return titles;
+        while (in >> paper_number && std::getline(in, title)) {
+            if (title.empty()) {
+                attrs.erase(paper_number);
+                continue;
+            }
+            title = lwg::replace_reserved_char(std::move(title), '&', "&amp;");
+            title = lwg::replace_reserved_char(std::move(title), '"', "&quot;");
+            attrs[paper_number] = " title=\"" + title + "\"";
+        }
+        return attrs;
     }
 
 }
@@ -48,7 +56,13 @@ auto lwg::metadata::read_from_path(std::filesystem::path const& path, bool verbo
       std::cout << "Reading section-tag index from: " << filename << std::endl;
     return {
         read_section_db(infile),
+        {},
         read_git_commit_times(path / "meta-data" / "dates"),
-        read_paper_titles(path / "meta-data" / "paper_titles.txt"),
+        read_paper_title_attrs(path / "meta-data" / "paper_titles.txt"),
     };
 }
+
+auto lwg::metadata::paper_title_attr(std::string_view paper_number) const -> std::string_view {
+    auto const it = paper_title_attrs.find(paper_number);
+    return it == paper_title_attrs.end() ? std::string_view{} : std::string_view{it->second};
+}
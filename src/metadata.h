@@ -3,16 +3,33 @@
 #include "sections.h"
 #include <map>
 #include <unordered_map>
+#include <functional>
+#include <string>
+#include <string_view>
 #include <ctime>
 #include <filesystem>
 
 namespace lwg {
 
+// Allows an unordered_map with std::string keys to be searched for a string_view.
+struct string_hash {
+    using is_transparent = void;
+    auto operator()(std::string_view s) const noexcept -> std::size_t { return std::hash<std::string_view>{}(s); }
+};
+
 // Various things read from meta-data/
 struct metadata {
     section_map section_db;
+    section_link_map section_links;
+      // The links to the sections in 'section_db', which are made once it is complete.
     std::map<int, std::time_t> git_commit_times;
-    std::unordered_map<std::string, std::string> paper_titles;
+    std::unordered_map<std::string, std::string, string_hash, std::equal_to<>> paper_title_attrs;
+      // The title of each paper in paper_titles.txt, escaped and formatted as an
+      // HTML title="..." attribute with a leading space, ready to be inserted into
+      // a link to the paper. Papers without a title are not included.
+
+    auto paper_title_attr(std::string_view paper_number) const -> std::string_view;
+      // The title attribute for 'paper_number', or an empty string if there is none.
 
     static metadata read_from_path(std::filesystem::path const& path, bool verbose = true);
 };
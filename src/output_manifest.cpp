@@ -0,0 +1,87 @@
+//        Copyright the C++ Library Working Group
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// SPDX-License-Identifier: BSL-1.0
+
+#include "output_manifest.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// The first line of the file. The version must be incremented whenever the
+// format changes, or the documents generated by report_generator change in
+// a way that is not reflected in the digests of their inputs.
+constexpr std::string_view manifest_header = "LWG output manifest 1";
+
+} // close unnamed namespace
+
+// The manifest is a text file, with the header and the fingerprint on the
+// first line, then one line per document, giving the digest and the filename.
+auto lwg::output_manifest::load(fs::path const & filename, std::uint64_t fingerprint) -> output_manifest {
+   output_manifest manifest{fingerprint};
+   std::ifstream in{filename};
+   std::string line;
+   if (!std::getline(in, line) or line != std::string(manifest_header) + ' ' + std::to_string(fingerprint)) {
+      return manifest;
+   }
+
+   while (std::getline(in, line)) {
+      std::istringstream fields{line};
+      std::uint64_t digest;
+      if (fields >> std::hex >> digest and fields.get() == ' ') {
+         std::string output;
+         std::getline(fields, output);
+         manifest.m_digests[output] = digest;
+      }
+   }
+   return manifest;
+}
+
+void lwg::output_manifest::save(fs::path const & filename) const {
+   std::error_code ec;
+   fs::create_directories(filename.parent_path(), ec);
+
+   auto tmp = filename;
+   tmp += ".tmp";
+   {
+      std::ofstream out{tmp};
+      out << manifest_header << ' ' << m_fingerprint << '\n';
+      for (auto const & [output, digest] : m_digests) {
+         out << std::hex << digest << std::dec << ' ' << output << '\n';
+      }
+      if (!out.flush()) {
+         throw std::runtime_error{"Unable to write output manifest " + tmp.string()};
+      }
+   }
+   fs::rename(tmp, filename, ec);
+   if (ec) {
+      fs::remove(tmp, ec);
+      throw std::runtime_error{"Unable to write output manifest " + filename.string()};
+   }
+}
+
+auto lwg::output_manifest::needs_update(fs::path const & output, std::uint64_t digest) -> bool {
+   auto const key = output.string();
+   if (auto it = m_digests.find(key); it != m_digests.end() and it->second == digest and fs::exists(output)) {
+      m_pending.erase(key);
+      ++m_unchanged;
+      return false;
+   }
+   m_pending.insert_or_assign(key, digest);
+   return true;
+}
+
+void lwg::output_manifest::mark_written(fs::path const & output) {
+   if (auto node = m_pending.extract(output.string())) {
+      m_digests.insert_or_assign(std::move(node.key()), node.mapped());
+      ++m_updated;
+   }
+}
@@ -0,0 +1,59 @@
+#ifndef INCLUDE_LWG_OUTPUT_MANIFEST_H
+#define INCLUDE_LWG_OUTPUT_MANIFEST_H
+
+// standard headers
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace lwg
+{
+
+// A record of the documents written by a previous run, and a digest of the
+// inputs that each one was generated from. When a document is about to be
+// generated again, a matching digest means its content would be unchanged,
+// so it can be left alone.
+//
+// The whole manifest is discarded if its fingerprint does not match, e.g.
+// because lwg-issues.xml has changed, which affects every document.
+class output_manifest {
+public:
+   explicit output_manifest(std::uint64_t fingerprint) : m_fingerprint{fingerprint} {}
+
+   static auto load(std::filesystem::path const & filename, std::uint64_t fingerprint) -> output_manifest;
+     // Read the manifest from 'filename'. If the file does not exist, is not
+     // readable, or was written for a different fingerprint or by a different
+     // version of this program, return an empty manifest.
+
+   void save(std::filesystem::path const & filename) const;
+     // Write the manifest to 'filename', creating its directory if needed.
+     // Throws 'runtime_error' if the file cannot be written.
+
+   auto needs_update(std::filesystem::path const & output, std::uint64_t digest) -> bool;
+     // Return 'true' if 'output' does not exist or was generated from inputs
+     // with a different digest. The caller must then regenerate 'output', and
+     // call 'mark_written' once it has been written, to record the new digest.
+     // Until then the old digest is kept, so if 'output' is not written,
+     // the next call will return 'true' again.
+
+   void mark_written(std::filesystem::path const & output);
+     // Record the digest of the inputs last passed to 'needs_update' for 'output'.
+     // Does nothing if that call returned 'false'.
+
+   auto updated() const noexcept -> std::size_t { return m_updated; }
+   auto unchanged() const noexcept -> std::size_t { return m_unchanged; }
+     // The number of documents that were written, and the number of calls to
+     // 'needs_update' that returned 'false'.
+
+private:
+   std::uint64_t                          m_fingerprint;
+   std::map<std::string, std::uint64_t>   m_digests;
+   std::map<std::string, std::uint64_t>   m_pending;   // not yet written
+   std::size_t                            m_updated = 0;
+   std::size_t                            m_unchanged = 0;
+};
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_OUTPUT_MANIFEST_H
@@ -0,0 +1,25 @@
+//        Copyright the C++ Library Working Group
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// SPDX-License-Identifier: BSL-1.0
+
+#include "papers.h"
+
+namespace {
+
+// parse_paper_number is constexpr, so check it at compile time.
+static_assert(lwg::parse_paper_number("N4950")->str() == "N4950");
+static_assert(lwg::parse_paper_number("p2300r10")->str() == "P2300R10");
+static_assert(lwg::parse_paper_number("d1234")->str() == "D1234");
+static_assert(!lwg::parse_paper_number(""));
+static_assert(!lwg::parse_paper_number("N"));
+static_assert(!lwg::parse_paper_number("N123R1"));
+static_assert(!lwg::parse_paper_number("P123R"));
+static_assert(!lwg::parse_paper_number("PR1"));
+static_assert(!lwg::parse_paper_number("P12R3R4"));
+static_assert(!lwg::parse_paper_number("P 123"));
+static_assert(!lwg::parse_paper_number("X123"));
+
+} // close unnamed namespace
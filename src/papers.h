@@ -0,0 +1,73 @@
+#ifndef INCLUDE_LWG_PAPERS_H
+#define INCLUDE_LWG_PAPERS_H
+
+// standard headers
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace lwg
+{
+
+// The number of a WG21 paper, e.g. N4950, P2300R10 or P1234, in upper case.
+class paper_number {
+public:
+   static constexpr std::size_t max_size = 15;
+
+   constexpr auto str() const noexcept -> std::string_view { return {m_chars.data(), m_size}; }
+
+   constexpr bool operator==(paper_number const & other) const noexcept { return str() == other.str(); }
+
+private:
+   friend constexpr auto parse_paper_number(std::string_view s) noexcept -> std::optional<paper_number>;
+
+   std::array<char, max_size> m_chars{};
+   std::size_t                m_size = 0;
+};
+
+constexpr auto parse_paper_number(std::string_view s) noexcept -> std::optional<paper_number> {
+   // Return the paper number 's' in upper case, if it is in one of the forms
+   // Nnnnn, Pnnnn, PnnnnRn, Dnnnn or DnnnnRn, in any case. This accepts the same
+   // strings as the regular expression "N\d+|[DP]\d+R\d+|[DP]\d+" (icase),
+   // except those longer than 'paper_number::max_size'.
+   if (s.empty() or s.size() > paper_number::max_size) {
+      return std::nullopt;
+   }
+
+   auto upper = [](char c) { return (c >= 'a' and c <= 'z') ? char(c - 'a' + 'A') : c; };
+   auto is_digit = [](char c) { return c >= '0' and c <= '9'; };
+
+   paper_number p;
+   p.m_size = s.size();
+   p.m_chars[0] = upper(s[0]);
+   if (p.m_chars[0] != 'N' and p.m_chars[0] != 'P' and p.m_chars[0] != 'D') {
+      return std::nullopt;
+   }
+
+   // A revision is only allowed for P and D papers, and must be followed by digits.
+   std::size_t digits = 0;
+   bool revision = false;
+   for (std::size_t i = 1; i != s.size(); ++i) {
+      char const c = upper(s[i]);
+      if (is_digit(c)) {
+         ++digits;
+      }
+      else if (c == 'R' and p.m_chars[0] != 'N' and !revision and digits != 0) {
+         revision = true;
+         digits = 0;
+      }
+      else {
+         return std::nullopt;
+      }
+      p.m_chars[i] = c;
+   }
+   if (digits == 0) {
+      return std::nullopt;
+   }
+   return p;
+}
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_PAPERS_H
@@ -0,0 +1,133 @@
+#ifndef INCLUDE_LWG_PARALLEL_H
+#define INCLUDE_LWG_PARALLEL_H
+
+// standard headers
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace lwg
+{
+
+// Convert a job count given on the command line or in the environment.
+// A value of 0 means "one job per core". More than four jobs per core
+// would not help, so larger values are reduced to that, with a warning,
+// rather than wrapping around when they do not fit in an 'unsigned'.
+// The count only affects the speed, so e.g. an LWG_JOBS set for a bigger
+// machine still works. Only a value that is not a number is an error.
+inline auto parse_jobs(std::string_view s) -> unsigned {
+   if (s.empty()) {
+      throw std::invalid_argument{"missing number of jobs"};
+   }
+   unsigned const cores = std::max(1u, std::thread::hardware_concurrency());
+   unsigned long long n = 0;
+   auto const [end, ec] = std::from_chars(s.data(), s.data() + s.size(), n);
+   if (ec == std::errc::invalid_argument or end != s.data() + s.size()) {
+      throw std::invalid_argument{"invalid number of jobs: \"" + std::string(s) + '"'};
+   }
+   if (ec == std::errc::result_out_of_range or n > 4ull * cores) {
+      std::cerr << "warning: too many jobs: \"" << s << "\", using " << 4 * cores << '\n';
+      return 4 * cores;
+   }
+   return n ? static_cast<unsigned>(n) : cores;
+}
+
+// Convert the value of a "-jN" or "-j N" command line option, 'opt'.
+// In the second form N is taken from the front of 'args', the arguments
+// that follow the option, and removed from it.
+inline auto parse_jobs_option(std::string_view opt, std::vector<std::string_view> & args) -> unsigned {
+   std::string_view n = opt.substr(2);
+   if (n.empty()) {
+      if (args.empty()) {
+         throw std::runtime_error{"Missing number of jobs after -j"};
+      }
+      n = args.front();
+      args.erase(args.begin());
+   }
+   return parse_jobs(n);
+}
+
+// The number of jobs requested by the LWG_JOBS environment variable,
+// or 1 (i.e. run serially) if it is not set.
+inline auto jobs_from_environment() -> unsigned {
+   if (const char* env = std::getenv("LWG_JOBS"); env and *env) {
+      return parse_jobs(env);
+   }
+   return 1;
+}
+
+namespace detail
+{
+// True while the current thread is running an item of a 'parallel_for'.
+inline thread_local bool in_parallel_for = false;
+}
+
+// Call f(i) for each i in [0, n) using up to 'jobs' threads.
+// Work items are handed out in increasing order of i.
+// If any call throws, no further items are started and the exception thrown
+// for the lowest i is rethrown once all threads have finished, so errors are
+// reported the same way as they would be by a serial loop.
+// A 'parallel_for' called by an item of another one runs serially, because
+// the outer one already keeps the threads busy, and starting 'jobs' threads
+// for each of its items would only add to the cost.
+template<typename F>
+void parallel_for(std::size_t n, unsigned jobs, F f) {
+   if (jobs <= 1 or n <= 1 or detail::in_parallel_for) {
+      for (std::size_t i = 0; i != n; ++i) {
+         f(i);
+      }
+      return;
+   }
+
+   std::atomic<std::size_t> next{0};
+   std::atomic<bool> stop{false};
+   std::mutex m;
+   std::size_t failed = n;
+   std::exception_ptr error;
+
+   auto work = [&] {
+      detail::in_parallel_for = true;
+      for (std::size_t i; not stop and (i = next++) < n; ) {
+         try {
+            f(i);
+         }
+         catch (...) {
+            std::lock_guard<std::mutex> lock{m};
+            if (i < failed) {
+               failed = i;
+               error = std::current_exception();
+            }
+            stop = true;
+         }
+      }
+      detail::in_parallel_for = false;
+   };
+
+   {
+      std::vector<std::jthread> workers;
+      workers.reserve(jobs - 1);
+      for (unsigned t = 1; t < jobs and t < n; ++t) {
+         workers.emplace_back(work);
+      }
+      work();
+   }
+
+   if (error) {
+      std::rethrow_exception(error);
+   }
+}
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_PARALLEL_H
@@ -11,7 +11,9 @@
 
 #include "report_generator.h"
 
+#include "file_utils.h"
 #include "mailing_info.h"
+#include "output_manifest.h"
 #include "sections.h"
 #include "html_utils.h"
 
@@ -20,7 +22,6 @@
 #include <chrono>
 #include <cstdlib>
 #include <format>
-#include <fstream>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
@@ -54,38 +55,17 @@ std::string const maintainer_name{"Jonathan Wakely"};
 
 std::string const is14882_docno{"ISO/IEC IS 14882:2024(E)"};
 
-struct order_by_first_tag {
-   bool operator()(lwg::issue const & x, lwg::issue const & y) const noexcept {
-      assert(!x.tags.empty());
-      assert(!y.tags.empty());
-      return x.tags.front() < y.tags.front();
-   }
-};
-
 // Similar to lwg::section_num but only looks at the first num in e.g. 17.5.2
 using major_section_key = std::pair<std::string_view, int>;
 
 // Find key for major section (i.e. Clause number, within a given IS or TS)
-auto lookup_major_section(lwg::section_map& db, const lwg::issue& i) -> major_section_key {
+auto lookup_major_section(lwg::section_map const & db, const lwg::issue& i) -> major_section_key {
    assert(!i.tags.empty());
-   const lwg::section_num& sect = db[i.tags[0]];
+   const lwg::section_num& sect = lwg::find_section(db, i.tags[0]);
+   assert(!sect.num.empty());
    return { sect.prefix, sect.num[0] };
 }
 
-struct order_by_major_section {
-   explicit order_by_major_section(lwg::section_map & sections)
-      : section_db(sections)
-      {
-      }
-
-   auto operator()(lwg::issue const & x, lwg::issue const & y) const -> bool {
-      return lookup_major_section(section_db, x) < lookup_major_section(section_db, y);
-   }
-
-private:
-   lwg::section_map& section_db;
-};
-
 // Create a LessThanComparable object that defines an ordering based on date,
 // with newer dates first.
 auto ordered_date(lwg::issue const & issue) {
@@ -98,13 +78,13 @@ auto ordered_date(lwg::issue const & issue) {
 // Using both is not redundant, because we use section 99 for all sections of some TS's.
 // Including the tag in the order gives a total order for sections in those TS's,
 // e.g., {99,[arrays.ts::dynarray]} < {99,[arrays.ts::dynarraconstructible_from.cons]}.
-auto ordered_section(lwg::section_map & section_db, lwg::issue const & issue) {
+auto ordered_section(lwg::section_map const & section_db, lwg::issue const & issue) {
    assert(!issue.tags.empty());
-   return std::tie(section_db[issue.tags.front()], issue.tags.front());
+   return std::tie(lwg::find_section(section_db, issue.tags.front()), issue.tags.front());
 }
 
 struct order_by_section {
-   explicit order_by_section(lwg::section_map &sections)
+   explicit order_by_section(lwg::section_map const & sections)
       : section_db(sections)
       {
       }
@@ -114,21 +94,17 @@ struct order_by_section {
    }
 
 private:
-   lwg::section_map& section_db;
-};
-
-struct order_by_status {
-   auto operator()(lwg::issue const & x, lwg::issue const & y) const noexcept -> bool {
-      return lwg::get_status_priority(x.stat) < lwg::get_status_priority(y.stat);
-   }
-   auto operator()(lwg::issue const & x, std::string_view y) const noexcept -> bool {
-      return lwg::get_status_priority(x.stat) < lwg::get_status_priority(y);
-   }
-   auto operator()(std::string_view x, lwg::issue const & y) const noexcept -> bool {
-      return lwg::get_status_priority(x) < lwg::get_status_priority(y.stat);
-   }
+   lwg::section_map const & section_db;
 };
 
+// Return pointers to the 'issues' sorted by 'proj', which is applied to each issue.
+// The issues themselves are not reordered, so each document can have its own order
+// while the others are being made.
+auto sorted_issues(std::span<lwg::issue const * const> issues, auto proj) -> std::vector<lwg::issue const *> {
+   std::vector<lwg::issue const *> sorted(issues.begin(), issues.end());
+   std::ranges::sort(sorted, {}, [&proj](lwg::issue const * i) { return std::invoke(proj, *i); });
+   return sorted;
+}
 
 // Replace spaces to make a string usable as an 'id' attribute,
 // or as an URL fragment (#foo) that links to an 'id' attribute.
@@ -249,7 +225,7 @@ void print_file_trailer(std::ostream& out) {
 }
 
 
-void print_table(std::ostream& out, std::span<const lwg::issue> issues, lwg::section_map& section_db, bool link_stable_names = false) {
+void print_table(std::ostream& out, std::span<lwg::issue const * const> issues, lwg::section_map const & section_db, bool link_stable_names = false) {
 #if defined (DEBUG_LOGGING)
    std::cout << "\t" << issues.size() << " items to add to table" << std::endl;
 #endif
@@ -268,11 +244,12 @@ R"(<table class="issues-index">
 )";
 
    lwg::section_tag prev_tag;
-   for (auto& i : issues) {
+   for (auto p : issues) {
+      auto const & i = *p;
       out << "<tr>\n";
 
       // Number
-      out << "<td id=\"" << i.num << "\">" << make_html_anchor(i)
+      out << "<td id=\"" << i.num << "\">" << i.anchor
           << "<sup><a href=\"https://cplusplus.github.io/LWG/issue" << i.num
           << "\">(i)</a></sup></td>\n";
 
@@ -283,7 +260,7 @@ R"(<table class="issues-index">
       // Section
       out << "<td>";
       assert(!i.tags.empty());
-      out << section_db[i.tags[0]] << " " << i.tags[0];
+      out << lwg::find_section(section_db, i.tags[0]) << " " << i.tags[0];
       if (link_stable_names && i.tags[0] != prev_tag) {
          prev_tag = i.tags[0];
          out << "<a id=\"" << as_string(prev_tag) << "\"></a>";
@@ -321,12 +298,7 @@ R"(<table class="issues-index">
 
 enum class print_issue_type { in_list, individual };
 
-using issue_set_by_first_tag = std::multiset<lwg::issue, order_by_first_tag>;
-using issue_set_by_status    = std::multiset<lwg::issue, order_by_status>;
-
-void print_issue(std::ostream & out, lwg::issue const & iss, lwg::section_map & section_db,
-                 issue_set_by_first_tag const & all_issues, issue_set_by_status const & issues_by_status,
-                 issue_set_by_first_tag const & active_issues, print_issue_type type = print_issue_type::in_list) {
+void print_issue(lwg::document_buffer & out, lwg::issue const & iss, std::string_view body, print_issue_type type = print_issue_type::in_list) {
          out << "<hr>\n";
 
          const auto status_idattr = spaces_to_underscores(std::string(lwg::remove_qualifier(iss.stat)));
@@ -348,14 +320,22 @@ void print_issue(std::ostream & out, lwg::issue const & iss, lwg::section_map &
               out << "<h3 id=\"" << iss.num << "\"><a href=\"" << lwg::filename_for_status(iss.stat) << '#' << iss.num << "\">" << iss.num << "</a>";
          }
 
+         out.splice(body);
+}
+
+// Print the part of 'iss' that is the same in every document that shows it, from its title to its text.
+void print_issue_body(std::ostream & out, lwg::issue const & iss, lwg::section_link_map const & section_links,
+                      lwg::issue_group_counts const & groups) {
+         const auto status_idattr = spaces_to_underscores(std::string(lwg::remove_qualifier(iss.stat)));
+
          // Title
          out << ". " << iss.title << "</h3>\n";
 
          // Section, Status, Submitter, Date
          out << "<p><b>Section:</b> ";
-         out << lwg::format_section_tag_as_link(section_db, iss.tags[0]);
+         out << section_links.find(iss.tags[0]);
          for (unsigned k = 1; k < iss.tags.size(); ++k) {
-            out << ", " << lwg::format_section_tag_as_link(section_db, iss.tags[k]);
+            out << ", " << section_links.find(iss.tags[k]);
          }
 
          out << " <b>Status:</b> <a href=\"lwg-active.html#" << status_idattr << "\">" << iss.stat << "</a>\n";
@@ -373,18 +353,18 @@ void print_issue(std::ostream & out, lwg::issue const & iss, lwg::section_map &
          out << "</p>\n";
 
          // view active issues in []
-         if (active_issues.count(iss) > 1) {
+         if (groups.active_in_section(iss) > 1) {
             out << "<p><b>View other</b> <a href=\"lwg-index-open.html#"
               << as_string(iss.tags[0]) << "\">active issues</a> in " << iss.tags[0] << ".</p>\n";
          }
 
          // view all issues in []
-         if (all_issues.count(iss) > 1) {
+         if (groups.in_section(iss) > 1) {
             out << "<p><b>View all other</b> <a href=\"lwg-index.html#"
               << as_string(iss.tags[0]) << "\">issues</a> in " << iss.tags[0] << ".</p>\n";
          }
          // view all issues with same status
-         if (issues_by_status.count(iss) > 1) {
+         if (groups.with_status(iss) > 1) {
             out << "<p><b>View all issues with</b> <a href=\"lwg-status.html#" << iss.stat << "\">" << iss.stat << "</a> status.</p>\n";
          }
 
@@ -400,27 +380,23 @@ void print_issue(std::ostream & out, lwg::issue const & iss, lwg::section_map &
 
 }
 
-template <typename Pred>
-void print_issues(std::ostream & out, std::span<const lwg::issue> issues, lwg::section_map & section_db, Pred pred) {
-   issue_set_by_first_tag const  all_issues{ issues.begin(), issues.end()} ;
-   issue_set_by_status    const  issues_by_status{ issues.begin(), issues.end() };
-
-   issue_set_by_first_tag active_issues;
-   for (auto const & elem : issues) {
-      if (lwg::is_active(elem.stat)) {
-         active_issues.insert(elem);
-      }
-   }
+// The number of issues in each chunk of an 'issue_list_document', which is small enough
+// that the chunks of the biggest documents can be shared between the threads.
+constexpr std::size_t issues_per_chunk = 256;
 
+template <typename Pred>
+auto select_issues(std::span<const lwg::issue> issues, Pred pred) -> std::vector<lwg::issue const *> {
+   std::vector<lwg::issue const *> selected;
    for (auto const & iss : issues) {
       if (pred(iss)) {
-          print_issue(out, iss, section_db, all_issues, issues_by_status, active_issues);
+         selected.push_back(&iss);
       }
    }
+   return selected;
 }
 
 template <typename Pred>
-void print_resolutions(std::ostream & out, std::span<const lwg::issue> issues, lwg::section_map & section_db, Pred predicate) {
+void print_resolutions(std::ostream & out, std::span<const lwg::issue> issues, lwg::section_map const & section_db, Pred predicate) {
    // This construction calls out for filter-iterators
 //   std::multiset<lwg::issue, order_by_first_tag> pending_issues;
    std::vector<lwg::issue> pending_issues;
@@ -481,79 +457,264 @@ R"(<table>
    out << "<p>" << build_timestamp << "</p>";
 }
 
+// Combine the hash of a sequence of strings, so that each document can be
+// identified by a digest of everything it is generated from.
+struct digest {
+   std::uint64_t value = lwg::hash_bytes({});
+
+   auto operator<<(std::string_view s) -> digest & {
+      // Include the length, so that e.g. "ab","c" and "a","bc" differ.
+      value = lwg::hash_bytes(std::to_string(s.size()) + ':', value);
+      value = lwg::hash_bytes(s, value);
+      return *this;
+   }
+
+   auto operator<<(std::uint64_t n) -> digest & {
+      return *this << std::to_string(n);
+   }
+
+   auto operator<<(std::chrono::year_month_day date) -> digest & {
+      return *this << std::to_string(static_cast<int>(date.year())) << static_cast<unsigned>(date.month())
+                   << static_cast<unsigned>(date.day());
+   }
+};
+
+// Return a digest of every part of 'iss' that can appear in a document.
+auto digest_issue(lwg::issue const & iss, lwg::section_map const & section_db, lwg::section_link_map const & section_links) -> std::uint64_t {
+   digest d;
+   d << std::to_string(iss.num) << iss.stat << iss.title << iss.doc_prefix << iss.submitter
+     << iss.date << iss.mod_date << std::to_string(iss.priority) << iss.owner << iss.has_resolution << iss.resolution << iss.text;
+   for (auto const & tag : iss.tags) {
+      d << lwg::find_section(section_db, tag).prefix << section_links.find(tag);
+   }
+   for (auto const & dup : iss.duplicates) {
+      d << dup;
+   }
+   return d.value;
+}
+
+// Add the digest of each issue in 'nums' to 'd', or return 'false' if one of them was not recorded.
+auto add_issue_digests(digest & d, std::unordered_map<int, std::uint64_t> const & issue_digests, auto && nums) -> bool {
+   for (int num : nums) {
+      auto it = issue_digests.find(num);
+      if (it == issue_digests.end()) {
+         return false;
+      }
+      d << it->second;
+   }
+   return true;
+}
+
 } // close unnamed namespace
 
 namespace lwg
 {
 
+issue_group_counts::issue_group_counts(std::span<const issue> issues) {
+   for (auto const & iss : issues) {
+      assert(!iss.tags.empty());
+      auto & c = by_first_tag[iss.tags.front()];
+      ++c.all;
+      if (is_active(iss.stat)) {
+         ++c.active;
+      }
+      ++by_status_priority[get_status_priority(iss.stat)];
+   }
+}
+
+auto issue_group_counts::in_section(issue const & iss) const -> std::size_t {
+   auto i = by_first_tag.find(iss.tags.front());
+   return i == by_first_tag.end() ? 0 : i->second.all;
+}
+
+auto issue_group_counts::active_in_section(issue const & iss) const -> std::size_t {
+   auto i = by_first_tag.find(iss.tags.front());
+   return i == by_first_tag.end() ? 0 : i->second.active;
+}
+
+auto issue_group_counts::with_status(issue const & iss) const -> std::size_t {
+   auto i = by_status_priority.find(get_status_priority(iss.stat));
+   return i == by_status_priority.end() ? 0 : i->second;
+}
+
+issue_fragments::issue_fragments(std::span<const issue> all, section_link_map const & links)
+   : issues(all)
+   , group_counts(all)
+   , section_links(links)
+   , bodies(std::make_unique<fragment[]>(all.size()))
+{
+}
+
+auto issue_fragments::body(issue const & iss) -> std::string_view {
+   assert(&iss >= issues.data() and &iss < issues.data() + issues.size());
+   auto & f = bodies[&iss - issues.data()];
+   std::call_once(f.rendered, [&] {
+      std::ostringstream out;
+      print_issue_body(out, iss, section_links, group_counts);
+      f.html = std::move(out).str();
+   });
+   return f.html;
+}
+
+issue_list_document::issue_list_document(fs::path filename, std::vector<issue const *> issues, issue_fragments & fragments)
+   : filename(std::move(filename))
+   , issues(std::move(issues))
+   , fragments(fragments)
+   , parts(std::max<std::size_t>(1, (this->issues.size() + issues_per_chunk - 1) / issues_per_chunk))
+   , remaining(parts.size())
+{
+}
+
+auto issue_list_document::print_chunk(std::size_t chunk) -> bool {
+   assert(chunk < parts.size());
+   auto const first = std::min(chunk * issues_per_chunk, issues.size());
+   auto const last = std::min(first + issues_per_chunk, issues.size());
+   for (auto i = first; i != last; ++i) {
+      print_issue(parts[chunk], *issues[i], fragments.body(*issues[i]));
+   }
+   // The thread that prints the last chunk must see the others, to write the document.
+   return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
+void report_generator::track_changes(output_manifest & m, std::span<const issue> issues) {
+   manifest = &m;
+   issue_digests.clear();
+   for (auto const & iss : issues) {
+      issue_digests[iss.num] = digest_issue(iss, section_db, section_links);
+   }
+}
+
+auto report_generator::is_unchanged(fs::path const & filename, std::span<const issue> issues, std::string_view extra) -> bool {
+   if (!manifest) {
+      return false;
+   }
+   digest d;
+   d << filename.filename().string() << extra;
+   if (!add_issue_digests(d, issue_digests, issues | std::views::transform(&issue::num))) {
+      return false;
+   }
+   std::lock_guard<std::mutex> lock{manifest_mutex};
+   return !manifest->needs_update(filename, d.value);
+}
+
+auto report_generator::is_unchanged(fs::path const & filename, std::span<issue const * const> issues, std::string_view extra) -> bool {
+   if (!manifest) {
+      return false;
+   }
+   digest d;
+   d << filename.filename().string() << extra;
+   if (!add_issue_digests(d, issue_digests, issues | std::views::transform([](issue const * i) { return i->num; }))) {
+      return false;
+   }
+   std::lock_guard<std::mutex> lock{manifest_mutex};
+   return !manifest->needs_update(filename, d.value);
+}
+
+template <typename Pred>
+auto report_generator::start_issue_list(fs::path filename, std::span<const issue> issues, Pred pred) -> std::unique_ptr<issue_list_document> {
+   return std::make_unique<issue_list_document>(std::move(filename), select_issues(issues, pred), fragments);
+}
+
+void report_generator::finish(issue_list_document & doc) {
+   auto & out = doc.head;
+   for (auto const & part : doc.parts) {
+      out.splice(part);
+   }
+   print_file_trailer(out);
+   write_document(out, doc.filename);
+}
+
+void report_generator::write_document(document_buffer const & out, fs::path const & filename) {
+   out.write_to(filename);
+   if (manifest) {
+      std::lock_guard<std::mutex> lock{manifest_mutex};
+      manifest->mark_written(filename);
+   }
+}
+
 // Functions to make the 3 standard published issues list documents
 // A precondition for calling any of these functions is that the list of issues is sorted in numerical order, by issue number.
 // While nothing disastrous will happen if this precondition is violated, the published issues list will list items
 // in the wrong order.
-void report_generator::make_active(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) {
+auto report_generator::start_active(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) -> std::unique_ptr<issue_list_document> {
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
 
    fs::path filename{path / "lwg-active.html"};
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   if (is_unchanged(filename, issues, diff_report))
+     return nullptr;
+   auto doc = start_issue_list(filename, issues, [](issue const & i) {return is_active(i.stat);});
+   auto & out = doc->head;
    print_file_header(out, "C++ Standard Library Active Issues List", filename.filename().string(),
          "Unresolved issues in the C++ Standard Library");
    print_paper_heading(out, "active", lwg_issues_xml);
-   out << lwg_issues_xml.get_intro("active") << '\n';
-   out << "<h2 id='History'>Revision History</h2>\n" << lwg_issues_xml.get_revisions(issues, diff_report) << '\n';
-   out << "<h2 id='Status'>Issue Status</h2>\n" << lwg_issues_xml.get_statuses() << '\n';
+   out.splice(lwg_issues_xml.get_intro("active"));
+   out << '\n';
+   // The revisions are copied, because the document is written after this returns.
+   out << "<h2 id='History'>Revision History</h2>\n";
+   out << lwg_issues_xml.get_revisions(issues, diff_report);
+   out << '\n';
+   out << "<h2 id='Status'>Issue Status</h2>\n";
+   out.splice(lwg_issues_xml.get_statuses());
+   out << '\n';
    out << "<h2 id='Issues'>Active Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_active(i.stat);} );
-   print_file_trailer(out);
+   return doc;
 }
 
 
-void report_generator::make_defect(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) {
+auto report_generator::start_defect(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) -> std::unique_ptr<issue_list_document> {
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
 
    fs::path filename{path / "lwg-defects.html"};
-   std::ofstream out(filename);
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   if (is_unchanged(filename, issues, diff_report))
+     return nullptr;
+   auto doc = start_issue_list(filename, issues, [](issue const & i) {return is_defect(i.stat);});
+   auto & out = doc->head;
    print_file_header(out, "C++ Standard Library Defect Reports and Accepted Issues", filename.filename().string(),
          "Resolved issues in the C++ Standard Library");
    print_paper_heading(out, "defect", lwg_issues_xml);
-   out << lwg_issues_xml.get_intro("defect") << '\n';
-   out << "<h2 id='History'>Revision History</h2>\n" << lwg_issues_xml.get_revisions(issues, diff_report) << '\n';
+   out.splice(lwg_issues_xml.get_intro("defect"));
+   out << '\n';
+   // The revisions are copied, because the document is written after this returns.
+   out << "<h2 id='History'>Revision History</h2>\n";
+   out << lwg_issues_xml.get_revisions(issues, diff_report);
+   out << '\n';
    out << "<h2 id='Issues'>Accepted Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_defect(i.stat);} );
-   print_file_trailer(out);
+   return doc;
 }
 
 
-void report_generator::make_closed(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) {
+auto report_generator::start_closed(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) -> std::unique_ptr<issue_list_document> {
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
 
    fs::path filename{path / "lwg-closed.html"};
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   if (is_unchanged(filename, issues, diff_report))
+     return nullptr;
+   auto doc = start_issue_list(filename, issues, [](issue const & i) {return is_closed(i.stat);});
+   auto & out = doc->head;
    print_file_header(out, "C++ Standard Library Closed Issues List", filename.filename().string(),
          "Rejected C++ standard library issues");
    print_paper_heading(out, "closed", lwg_issues_xml);
-   out << lwg_issues_xml.get_intro("closed") << '\n';
-   out << "<h2 id='History'>Revision History</h2>\n" << lwg_issues_xml.get_revisions(issues, diff_report) << '\n';
+   out.splice(lwg_issues_xml.get_intro("closed"));
+   out << '\n';
+   // The revisions are copied, because the document is written after this returns.
+   out << "<h2 id='History'>Revision History</h2>\n";
+   out << lwg_issues_xml.get_revisions(issues, diff_report);
+   out << '\n';
    out << "<h2 id='Issues'>Closed Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_closed(i.stat);} );
-   print_file_trailer(out);
+   return doc;
 }
 
 
 // Additional non-standard documents, useful for running LWG meetings
-void report_generator::make_tentative(std::span<const issue> issues, fs::path const & path) {
+auto report_generator::start_tentative(std::span<const issue> issues, fs::path const & path) -> std::unique_ptr<issue_list_document> {
    // publish a document listing all tentative issues that may be acted on during a meeting.
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
 
    fs::path filename{path / "lwg-tentative.html"};
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   if (is_unchanged(filename, issues))
+     return nullptr;
+   auto doc = start_issue_list(filename, issues, [](issue const & i) {return is_tentative(i.stat);});
+   auto & out = doc->head;
    print_file_header(out, "C++ Standard Library Tentative Issues");
 //   print_paper_heading(out, "active", lwg_issues_xml);
 //   out << lwg_issues_xml.get_intro("active") << '\n';
@@ -561,19 +722,19 @@ void report_generator::make_tentative(std::span<const issue> issues, fs::path co
 //   out << "<h2 id='Status'>Issue Status</h2>\n" << lwg_issues_xml.get_statuses() << '\n';
    out << "<p>" << build_timestamp << "</p>";
    out << "<h2>Tentative Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_tentative(i.stat);} );
-   print_file_trailer(out);
+   return doc;
 }
 
 
-void report_generator::make_unresolved(std::span<const issue> issues, fs::path const & path) {
+auto report_generator::start_unresolved(std::span<const issue> issues, fs::path const & path) -> std::unique_ptr<issue_list_document> {
    // publish a document listing all non-tentative, non-ready issues that must be reviewed during a meeting.
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
 
    fs::path filename{path / "lwg-unresolved.html"};
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   if (is_unchanged(filename, issues))
+     return nullptr;
+   auto doc = start_issue_list(filename, issues, [](issue const & i) {return is_not_resolved(i.stat);});
+   auto & out = doc->head;
    print_file_header(out, "C++ Standard Library Unresolved Issues");
 //   print_paper_heading(out, "active", lwg_issues_xml);
 //   out << lwg_issues_xml.get_intro("active") << '\n';
@@ -581,18 +742,18 @@ void report_generator::make_unresolved(std::span<const issue> issues, fs::path c
 //   out << "<h2 id='Status'></a>Issue Status</h2>\n" << lwg_issues_xml.get_statuses() << '\n';
    out << "<p>" << build_timestamp << "</p>";
    out << "<h2>Unresolved Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return is_not_resolved(i.stat);} );
-   print_file_trailer(out);
+   return doc;
 }
 
-void report_generator::make_immediate(std::span<const issue> issues, fs::path const & path) {
+auto report_generator::start_immediate(std::span<const issue> issues, fs::path const & path) -> std::unique_ptr<issue_list_document> {
    // publish a document listing all non-tentative, non-ready issues that must be reviewed during a meeting.
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
 
    fs::path filename{path / "lwg-immediate.html"};
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   if (is_unchanged(filename, issues))
+     return nullptr;
+   auto doc = start_issue_list(filename, issues, [](issue const & i) {return "Immediate" == i.stat;});
+   auto & out = doc->head;
    print_file_header(out, "C++ Standard Library Issues Resolved Directly In [INSERT CURRENT MEETING HERE]");
 out << R"(<h1>C++ Standard Library Issues Resolved Directly In [INSERT CURRENT MEETING HERE]</h1>
 <table>
@@ -616,18 +777,18 @@ out << R"(<h1>C++ Standard Library Issues Resolved Directly In [INSERT CURRENT M
 </table>
 )";
    out << "<h2>Immediate Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return "Immediate" == i.stat;} );
-   print_file_trailer(out);
+   return doc;
 }
 
-void report_generator::make_ready(std::span<const issue> issues, fs::path const & path) {
+auto report_generator::start_ready(std::span<const issue> issues, fs::path const & path) -> std::unique_ptr<issue_list_document> {
    // publish a document listing all ready issues for a formal vote
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
 
    fs::path filename{path / "lwg-ready.html"};
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   if (is_unchanged(filename, issues))
+     return nullptr;
+   auto doc = start_issue_list(filename, issues, [](issue const & i) {return "Ready" == i.stat || "Tentatively Ready" == i.stat;});
+   auto & out = doc->head;
    print_file_header(out, "C++ Standard Library Issues to be moved in [INSERT CURRENT MEETING HERE]");
 out << R"(<h1>C++ Standard Library Issues to be moved in [INSERT CURRENT MEETING HERE]</h1>
 <table>
@@ -651,8 +812,7 @@ out << R"(<h1>C++ Standard Library Issues to be moved in [INSERT CURRENT MEETING
 </table>
 )";
    out << "<h2>Ready Issues</h2>\n";
-   print_issues(out, issues, section_db, [](issue const & i) {return "Ready" == i.stat || "Tentatively Ready" == i.stat;} );
-   print_file_trailer(out);
+   return doc;
 }
 
 void report_generator::make_editors_issues(std::span<const issue> issues, fs::path const & path) {
@@ -660,22 +820,22 @@ void report_generator::make_editors_issues(std::span<const issue> issues, fs::pa
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
 
    fs::path filename{path / "lwg-issues-for-editor.html"};
-   std::ofstream out{filename};
-   if (!out) {
-     throw std::runtime_error{"Failed to open " + filename.string()};
-   }
+   if (is_unchanged(filename, issues))
+     return;
+   lwg::document_buffer out;
    print_file_header(out, "C++ Standard Library Issues Resolved Directly In [INSERT CURRENT MEETING HERE]");
    out << "<h1>C++ Standard Library Issues Resolved In [INSERT CURRENT MEETING HERE]</h1>\n";
    print_resolutions(out, issues, section_db, [](issue const & i) {return "Pending WP" == i.stat;} );
    print_file_trailer(out);
+   write_document(out, filename);
 }
 
-void report_generator::make_sort_by_num(std::span<issue> issues, fs::path const & filename) {
-   std::ranges::sort(issues, {}, &issue::num);
+void report_generator::make_sort_by_num(std::span<issue const * const> unsorted, fs::path const & filename) {
+   auto const issues = sorted_issues(unsorted, &issue::num);
+   if (is_unchanged(filename, issues))
+     return;
 
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   lwg::document_buffer out;
    print_file_header(out, "LWG Table of Contents");
 
    out <<
@@ -689,6 +849,7 @@ R"(<h1>C++ Standard Library Issues List (Revision )" << lwg_issues_xml.get_revis
 
    print_table(out, issues, section_db);
    print_file_trailer(out);
+   write_document(out, filename);
 }
 
 #ifndef __cpp_lib_ranges_chunk_by
@@ -702,7 +863,8 @@ auto chop(std::span<T>& s, std::size_t n)
 
 // Chop off and return  a subspan from the front of `issues`,
 // consisting of all values that are equivalent under `pred`.
-auto chunk_by(std::span<issue>& issues, auto pred) -> std::span<const issue> {
+template<typename T>
+auto chunk_by(std::span<T>& issues, auto pred) -> std::span<T> {
    std::size_t n = 0;
    if (!issues.empty()) {
       auto end = std::ranges::find_if_not(issues, std::bind_front(pred, std::ref(issues.front())));
@@ -712,15 +874,16 @@ auto chunk_by(std::span<issue>& issues, auto pred) -> std::span<const issue> {
 }
 #endif
 
-void report_generator::make_sort_by_priority(std::span<issue> issues, fs::path const & filename) {
+void report_generator::make_sort_by_priority(std::span<issue const * const> unsorted, fs::path const & filename) {
    auto proj = [this](const auto& i) {
-      return std::tie(i.priority, section_db[i.tags.front()], i.num);
+      return std::tie(i.priority, lwg::find_section(section_db, i.tags.front()), i.num);
    };
-   std::ranges::sort(issues, {}, proj);
+   auto sorted = sorted_issues(unsorted, proj);
+   std::span<issue const *> issues{sorted};
+   if (is_unchanged(filename, issues))
+     return;
 
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   lwg::document_buffer out;
    print_file_header(out, "LWG Table of Contents");
 
    out <<
@@ -735,8 +898,8 @@ sorted by priority.</p>
 
 //   print_table(out, issues, section_db);
 
-   auto same_prio = [](const issue& lhs, const issue& rhs) {
-     return lhs.priority == rhs.priority;
+   auto same_prio = [](const issue* lhs, const issue* rhs) {
+     return lhs->priority == rhs->priority;
    };
 #ifdef __cpp_lib_ranges_chunk_by
    for (auto chunk : issues | std::views::chunk_by(same_prio))
@@ -745,7 +908,7 @@ sorted by priority.</p>
        chunk = chunk_by(issues, same_prio))
 #endif
    {
-      const int px = chunk.front().priority;
+      const int px = chunk.front()->priority;
       out << "<h2 id=\"Priority_" << px << "\">";
       if (px == 99) {
          out << "Not Prioritized";
@@ -758,12 +921,14 @@ sorted by priority.</p>
    }
 
    print_file_trailer(out);
+   write_document(out, filename);
 }
 
-void report_generator::make_sort_by_status_impl(std::span<issue> issues, fs::path const & filename, std::string title) {
-   std::ofstream out{filename};
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+void report_generator::make_sort_by_status_impl(std::span<issue const * const> issues, fs::path const & filename, std::string title) {
+   if (is_unchanged(filename, issues, title))
+     return;
+
+   lwg::document_buffer out;
    print_file_header(out, "LWG Index by " + title, filename.filename().string(),
          "C++ standard library issues list");
 
@@ -779,8 +944,8 @@ This document is the Index by )" << title << R"( for the <a href="lwg-active.htm
 )";
    out << "<p>" << build_timestamp << "</p>";
 
-   auto same_status = [](const issue& lhs, const issue& rhs) {
-     return lhs.stat == rhs.stat;
+   auto same_status = [](const issue* lhs, const issue* rhs) {
+     return lhs->stat == rhs->stat;
    };
 #ifdef __cpp_lib_ranges_chunk_by
    for (auto chunk : issues | std::views::chunk_by(same_status))
@@ -789,7 +954,7 @@ This document is the Index by )" << title << R"( for the <a href="lwg-active.htm
        chunk = chunk_by(issues, same_status))
 #endif
    {
-      std::string current_status = chunk.front().stat;
+      std::string current_status = chunk.front()->stat;
       auto idattr = spaces_to_underscores(current_status);
       out << "<h2 id=\"" << idattr << "\">" << current_status
         << " (" << chunk.size() << " issues)</h2>\n";
@@ -797,55 +962,56 @@ This document is the Index by )" << title << R"( for the <a href="lwg-active.htm
    }
 
    print_file_trailer(out);
+   write_document(out, filename);
 }
 
 
-void report_generator::make_sort_by_status(std::span<issue> issues, fs::path const & filename) {
+void report_generator::make_sort_by_status(std::span<issue const * const> issues, fs::path const & filename) {
    auto proj = [this](const auto& i) {
       return std::make_tuple(lwg::get_status_priority(i.stat), ordered_section(section_db, i), ordered_date(i), i.num);
    };
-   std::ranges::sort(issues, {}, proj);
-   make_sort_by_status_impl(issues, filename, "Status and Section");
+   make_sort_by_status_impl(sorted_issues(issues, proj), filename, "Status and Section");
 }
 
 
-void report_generator::make_sort_by_status_mod_date(std::span<issue> issues, fs::path const & filename) {
+void report_generator::make_sort_by_status_mod_date(std::span<issue const * const> issues, fs::path const & filename) {
    auto proj = [this](const auto& i) {
       return std::make_tuple(lwg::get_status_priority(i.stat), ordered_date(i), ordered_section(section_db, i), i.num);
    };
-   std::ranges::sort(issues, {}, proj);
-   make_sort_by_status_impl(issues, filename, "Status and Date");
+   make_sort_by_status_impl(sorted_issues(issues, proj), filename, "Status and Date");
 }
 
 
-void report_generator::make_sort_by_section(std::span<issue> issues, fs::path const & filename, bool active_only) {
+void report_generator::make_sort_by_section(std::span<issue const * const> unsorted, fs::path const & filename, bool active_only) {
    auto proj = [](const auto& i) {
       return std::make_tuple(lwg::get_status_priority(i.stat), ordered_date(i), i.num);
    };
-   std::ranges::sort(issues, {}, proj);
+   auto sorted = sorted_issues(unsorted, proj);
+   std::span<issue const *> issues{sorted};
 
    if (active_only) {
-      auto status_priority = [](const issue& i) { return lwg::get_status_priority(i.stat); };
+      auto status_priority = [](const issue* i) { return lwg::get_status_priority(i->stat); };
       // Find the first issue not in Voting, Immediate, or Ready status:
       auto first = std::ranges::upper_bound(issues, lwg::get_status_priority("Ready"), {}, status_priority);
       // Find the end of the active issues:
-      auto last = std::ranges::find_if_not(first, issues.end(), is_active, &issue::stat);
+      auto last = std::ranges::find_if_not(first, issues.end(), [](const issue* i) { return is_active(i->stat); });
       // Trim the span to only those active issues:
-      issues = std::span<issue>(first, last);
+      issues = std::span<issue const *>(first, last);
    }
-   std::ranges::stable_sort(issues, order_by_section{section_db});
-   std::set<issue, order_by_major_section> mjr_section_open{order_by_major_section{section_db}};
+   std::ranges::stable_sort(issues, order_by_section{section_db}, [](const issue* i) -> const issue& { return *i; });
+   std::set<major_section_key> mjr_section_open;
    if (!active_only) {
-      for (auto const & elem : issues) {
-         if (is_active_not_ready(elem.stat)) {
-            mjr_section_open.insert(elem);
+      for (auto elem : issues) {
+         if (is_active_not_ready(elem->stat)) {
+            mjr_section_open.insert(lookup_major_section(section_db, *elem));
          }
       }
    }
 
-   std::ofstream out(filename);
-   if (!out)
-     throw std::runtime_error{"Failed to open " + filename.string()};
+   if (is_unchanged(filename, issues, active_only ? "active only" : ""))
+     return;
+
+   lwg::document_buffer out;
    print_file_header(out, "LWG Index by Section", filename.filename().string(),
          "C++ standard library issues list");
 
@@ -870,11 +1036,11 @@ void report_generator::make_sort_by_section(std::span<issue> issues, fs::path co
    }
    out << "<p>" << build_timestamp << "</p>";
 
-   auto lookup_section = [this](const issue& i) {
-      return lookup_major_section(section_db, i);
+   auto lookup_section = [this](const issue* i) {
+      return lookup_major_section(section_db, *i);
    };
 
-   auto same_section = [&](const issue& lhs, const issue& rhs) {
+   auto same_section = [&](const issue* lhs, const issue* rhs) {
      return lookup_section(lhs) == lookup_section(rhs);
    };
 #ifdef __cpp_lib_ranges_chunk_by
@@ -884,7 +1050,7 @@ void report_generator::make_sort_by_section(std::span<issue> issues, fs::path co
        chunk = chunk_by(issues, same_section))
 #endif
    {
-      const issue& i = chunk.front();
+      const issue* i = chunk.front();
       major_section_key current = lookup_section(i);
       std::string const msn = to_string(current);
       auto idattr = spaces_to_underscores(msn);
@@ -893,40 +1059,39 @@ void report_generator::make_sort_by_section(std::span<issue> issues, fs::path co
       if (active_only) {
          out << "<p><a href=\"lwg-index.html#Section_" << idattr << "\">(view all issues)</a></p>\n";
       }
-      else if (mjr_section_open.count(i) > 0) {
+      else if (mjr_section_open.count(current) > 0) {
          out << "<p><a href=\"lwg-index-open.html#Section_" << idattr << "\">(view only non-Ready open issues)</a></p>\n";
       }
       print_table(out, chunk, section_db, true);
    }
 
    print_file_trailer(out);
+   write_document(out, filename);
 }
 
 // Create individual HTML files for each issue, to make linking to a single issue easier.
 void report_generator::make_individual_issues(std::span<const issue> issues, fs::path const & path) {
    assert(std::ranges::is_sorted(issues, {}, &issue::num));
-   issue_set_by_first_tag const  all_issues{ issues.begin(), issues.end()} ;
-   issue_set_by_status    const  issues_by_status{ issues.begin(), issues.end() };
-
-   issue_set_by_first_tag active_issues;
-   for (auto const & elem : issues) {
-      if (lwg::is_active(elem.stat)) {
-         active_issues.insert(elem);
-      }
-   }
+   auto const & groups = fragments.groups();
 
    for(auto & iss : issues){
       auto num = std::to_string(iss.num);
       fs::path filename{path / ("issue" + num + ".html")};
-      std::ofstream out{filename};
-      if (!out)
-         throw std::runtime_error{"Failed to open " + filename.string()};
+      if (manifest) {
+         // The links to other issues in the same section or status depend on the other issues.
+         auto const related = std::format("{} {} {}", groups.active_in_section(iss) > 1, groups.in_section(iss) > 1,
+                                          groups.with_status(iss) > 1);
+         if (is_unchanged(filename, {&iss, 1}, related))
+            continue;
+      }
+      lwg::document_buffer out;
       print_file_header(out, "Issue " + num + ": " + lwg::strip_xml_elements(iss.title),
             // XXX should we use e.g. lwg-active.html#num as the canonical URL for the issue?
             filename.filename().string(),
             "C++ library issue. Status: " + iss.stat);
-      print_issue(out, iss, section_db, all_issues, issues_by_status, active_issues, print_issue_type::individual);
+      print_issue(out, iss, fragments.body(iss), print_issue_type::individual);
       print_file_trailer(out);
+      write_document(out, filename);
    }
 }
 } // close namespace lwg
@@ -1,10 +1,18 @@
 #ifndef INCLUDE_LWG_REPORT_GENERATOR_H
 #define INCLUDE_LWG_REPORT_GENERATOR_H
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <span>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
+#include "file_utils.h"
 #include "issues.h"  // cannot forward declare the 'section_map' alias, nor the 'LwgIssuesXml' alias
 
 namespace fs = std::filesystem;
@@ -13,59 +21,183 @@ namespace lwg
 {
 struct issue;
 struct mailing_info;
+class output_manifest;
+struct report_generator;
 
+// The number of issues in each of the groups that the page for an issue links to:
+// the issues in its first section, the active issues in that section, and the issues
+// with its status. Only the counts are kept, so the issues can be reordered after
+// they are counted, but not added, removed or changed.
+class issue_group_counts {
+public:
+   explicit issue_group_counts(std::span<const issue> issues);
 
+   auto in_section(issue const & iss) const -> std::size_t;
+      // The number of issues whose first section is the first section of 'iss'.
+
+   auto active_in_section(issue const & iss) const -> std::size_t;
+      // The number of active issues whose first section is the first section of 'iss',
+      // which does not include 'iss' if it is not active itself.
+
+   auto with_status(issue const & iss) const -> std::size_t;
+      // The number of issues whose status has the same priority as the status of 'iss'.
+
+private:
+   struct counts {
+      std::size_t all = 0;
+      std::size_t active = 0;
+   };
+
+   std::map<section_tag, counts> by_first_tag;
+   std::map<std::ptrdiff_t, std::size_t> by_status_priority;
+};
+
+// The HTML for each issue that is the same in every document that shows it, from its
+// title to its text. Each issue is rendered the first time it is shown, and then
+// copied into the other documents, so the issues must not change or move while this
+// object exists. Documents that are made at the same time can share the fragments.
+class issue_fragments {
+public:
+   issue_fragments(std::span<const issue> issues, section_link_map const & links);
+
+   auto body(issue const & iss) -> std::string_view;
+      // The HTML for 'iss', which must be one of the 'issues' passed to the constructor.
+
+   auto groups() const -> issue_group_counts const & { return group_counts; }
+
+private:
+   struct fragment {
+      std::once_flag rendered;
+      std::string    html;
+   };
+
+   std::span<const issue> issues;
+   issue_group_counts group_counts;
+   section_link_map const & section_links;
+   std::unique_ptr<fragment[]> bodies;   // one for each of 'issues', in the same order
+};
+
+// One of the documents that show the issues in full, such as lwg-active.html, started
+// by a 'report_generator'. Printing the issues is most of the work of making the
+// document, so they are printed in chunks of consecutive issues, each into its own
+// buffer. The chunks can be printed in any order, by different threads at the same
+// time, and the document is written once they are all printed.
+class issue_list_document {
+public:
+   issue_list_document(fs::path filename, std::vector<issue const *> issues, issue_fragments & fragments);
+
+   auto chunks() const noexcept -> std::size_t { return parts.size(); }
+      // The number of chunks, which is at least one, so that the document is always written.
+
+   auto print_chunk(std::size_t chunk) -> bool;
+      // Print the issues in 'chunk', and return 'true' if every chunk has now been printed,
+      // and so the document can be finished by 'report_generator::finish'.
+
+private:
+   friend struct report_generator;
+
+   fs::path                        filename;
+   document_buffer                 head;    // the part before the issues
+   std::vector<issue const *>      issues;
+   issue_fragments &               fragments;
+   std::vector<document_buffer>    parts;   // one for each chunk
+   std::atomic<std::size_t>        remaining;
+};
+
+
+// Each of the functions that make a document may be called from a different thread
+// at the same time. The documents made by one generator can only show the issues that
+// it was constructed with, and those must not change or move until it is destroyed.
 struct report_generator {
 
-   report_generator(mailing_info const & info, section_map & sections)
+   report_generator(std::span<const issue> issues, mailing_info const & info, section_map const & sections,
+                    section_link_map const & links)
       : lwg_issues_xml(info)
       , section_db(sections)
+      , section_links(links)
+      , fragments(issues, links)
    {
    }
 
-   // Functions to make the 3 standard published issues list documents
+   // Functions to start the 3 standard published issues list documents
    // A precondition for calling any of these functions is that the list of issues is sorted in numerical order, by issue number.
    // While nothing disastrous will happen if this precondition is violated, the published issues list will list items
    // in the wrong order.
-   void make_active(std::span<const issue> issues, fs::path const & path, std::string const & diff_report);
+   // Like the other documents that show the issues in full, these return the document
+   // with its issues still to be printed, or a null pointer if it is unchanged.
+   // Once every chunk is printed, call 'finish' to write it.
+   auto start_active(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) -> std::unique_ptr<issue_list_document>;
 
-   void make_defect(std::span<const issue> issues, fs::path const & path, std::string const & diff_report);
+   auto start_defect(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) -> std::unique_ptr<issue_list_document>;
 
-   void make_closed(std::span<const issue> issues, fs::path const & path, std::string const & diff_report);
+   auto start_closed(std::span<const issue> issues, fs::path const & path, std::string const & diff_report) -> std::unique_ptr<issue_list_document>;
 
    // Additional non-standard documents, useful for running LWG meetings
-   void make_tentative(std::span<const issue> issues, fs::path const & path);
+   auto start_tentative(std::span<const issue> issues, fs::path const & path) -> std::unique_ptr<issue_list_document>;
       // publish a document listing all tentative issues that may be acted on during a meeting.
 
 
-   void make_unresolved(std::span<const issue> issues, fs::path const & path);
+   auto start_unresolved(std::span<const issue> issues, fs::path const & path) -> std::unique_ptr<issue_list_document>;
       // publish a document listing all non-tentative, non-ready issues that must be reviewed during a meeting.
 
-   void make_immediate(std::span<const issue> issues, fs::path const & path);
+   auto start_immediate(std::span<const issue> issues, fs::path const & path) -> std::unique_ptr<issue_list_document>;
       // publish a document listing all non-tentative, non-ready issues that must be reviewed during a meeting.
 
-   void make_ready(std::span<const issue> issues, fs::path const & path);
+   auto start_ready(std::span<const issue> issues, fs::path const & path) -> std::unique_ptr<issue_list_document>;
       // publish a document listing all ready issues for a formal vote
 
-   void make_sort_by_num(std::span<issue> issues, fs::path const & filename);
+   void finish(issue_list_document & doc);
+      // Write 'doc', once all of its chunks have been printed.
+
+   void make_sort_by_num(std::span<issue const * const> issues, fs::path const & filename);
 
-   void make_sort_by_priority(std::span<issue> issues, fs::path const & filename);
+   void make_sort_by_priority(std::span<issue const * const> issues, fs::path const & filename);
 
-   void make_sort_by_status(std::span<issue> issues, fs::path const & filename);
+   void make_sort_by_status(std::span<issue const * const> issues, fs::path const & filename);
 
-   void make_sort_by_status_mod_date(std::span<issue> issues, fs::path const & filename);
+   void make_sort_by_status_mod_date(std::span<issue const * const> issues, fs::path const & filename);
 
-   void make_sort_by_section(std::span<issue> issues, fs::path const & filename, bool active_only = false);
+   void make_sort_by_section(std::span<issue const * const> issues, fs::path const & filename, bool active_only = false);
+      // The 'make_sort_by_' functions show the 'issues' in their own order, without reordering them.
 
    void make_editors_issues(std::span<const issue> issues, fs::path const & path);
 
    void make_individual_issues(std::span<const issue> issues, fs::path const & path);
 
+   // Incremental rebuilds
+   void track_changes(output_manifest & manifest, std::span<const issue> issues);
+      // Record a digest of the inputs of every document generated from now on
+      // in 'manifest', and do not write any document whose digest is unchanged.
+      // 'issues' must be every issue, formatted as HTML, so that each document
+      // can be keyed on the content of the issues it shows. The digest of an
+      // issue covers its text after <iref> elements are replaced by anchors,
+      // so it changes when the status or title of a referenced issue changes.
+      // The revision timestamp is not part of any digest, so it is only updated
+      // in documents that are rewritten.
+
 private:
-   void make_sort_by_status_impl(std::span<issue> issues, fs::path const & filename, std::string title);
+   void make_sort_by_status_impl(std::span<issue const * const> issues, fs::path const & filename, std::string title);
+
+   auto is_unchanged(fs::path const & filename, std::span<const issue> issues, std::string_view extra = {}) -> bool;
+   auto is_unchanged(fs::path const & filename, std::span<issue const * const> issues, std::string_view extra = {}) -> bool;
+      // Return 'true' if changes are being tracked and the document 'filename',
+      // showing 'issues' and 'extra', is the same as when it was last written.
+
+   template <typename Pred>
+   auto start_issue_list(fs::path filename, std::span<const issue> issues, Pred pred) -> std::unique_ptr<issue_list_document>;
+      // Start a document showing the 'issues' that satisfy 'pred'.
+
+   void write_document(document_buffer const & out, fs::path const & filename);
+      // Write 'out' to 'filename', then record in the manifest that it was
+      // written, so that a failure to write it is retried on the next build.
 
    mailing_info const & lwg_issues_xml;
-   section_map &        section_db;
+   section_map const &  section_db;
+   section_link_map const & section_links;
+   output_manifest *    manifest = nullptr;
+   std::mutex           manifest_mutex;
+   std::unordered_map<int, std::uint64_t> issue_digests;
+   issue_fragments      fragments;
 };
 
 } // close namespace lwg
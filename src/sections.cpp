@@ -8,6 +8,7 @@
 #include "sections.h"
 
 #include <cassert>
+#include <stdexcept>
 #include <sstream>
 #include <iostream>
 #include <cctype>
@@ -149,9 +150,28 @@ auto lwg::read_section_db(std::istream & infile) -> section_map {
    return section_db;
 }
 
-auto lwg::format_section_tag_as_link(section_map & section_db, section_tag const & tag) -> std::string {
+auto lwg::find_section(section_map const & section_db, section_tag const & tag) -> section_num const & {
+   static section_num const unknown;
+   auto const i = section_db.find(tag);
+   return i == section_db.end() ? unknown : i->second;
+}
+
+auto lwg::find_section_reference(section_map const & section_db, std::string const & doc_prefix, std::string_view name) -> section_tag {
+   section_tag tag{doc_prefix, std::string(name)};
+   // heuristic: if the name is not found using the doc_prefix, try
+   // using no prefix (i.e. the C++ standard itself)
+   if (!tag.prefix.empty() && section_db.find(tag) == section_db.end()) {
+      section_tag fallback_tag{{}, tag.name};
+      if (section_db.find(fallback_tag) != section_db.end()) {
+         tag = std::move(fallback_tag);
+      }
+   }
+   return tag;
+}
+
+auto lwg::format_section_tag_as_link(section_map const & section_db, section_tag const & tag) -> std::string {
    std::ostringstream o;
-   const auto& num = section_db[tag];
+   const auto& num = find_section(section_db, tag);
    o << num << ' ';
    std::string url;
    if  (!tag.prefix.empty()) {
@@ -181,3 +201,33 @@ auto lwg::format_section_tag_as_link(section_map & section_db, section_tag const
    return o.str();
 }
 
+lwg::section_link_map::section_link_map(section_map const & section_db) {
+   for (auto const & elem : section_db) {
+      m_links.emplace_hint(m_links.end(), elem.first, format_section_tag_as_link(section_db, elem.first));
+   }
+}
+
+auto lwg::section_link_map::find_key(key k) const -> std::string const * {
+   auto const i = m_links.find(k);
+   return i == m_links.end() ? nullptr : &i->second;
+}
+
+auto lwg::section_link_map::find(section_tag const & tag) const -> std::string_view {
+   if (auto link = find_key(key_less::as_key(tag))) {
+      return *link;
+   }
+   throw std::runtime_error{"Section " + as_string(tag) + " is not in the section index"};
+}
+
+auto lwg::section_link_map::find_reference(std::string_view doc_prefix, std::string_view name) const -> std::string_view {
+   // The same heuristic as 'find_section_reference', but without making a 'section_tag'.
+   if (auto link = find_key({doc_prefix, name})) {
+      return *link;
+   }
+   if (!doc_prefix.empty()) {
+      if (auto link = find_key({{}, name})) {
+         return *link;
+      }
+   }
+   throw std::runtime_error{"Section " + std::string(name) + " is not in the section index"};
+}
@@ -4,6 +4,8 @@
 #include <iosfwd>
 #include <map>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace lwg
@@ -37,7 +39,50 @@ auto read_section_db(std::istream & stream) -> section_map;
    // from the specified 'stream', and return it as a new
    // 'section_map' object.
 
-auto format_section_tag_as_link(section_map & section_db, section_tag const & tag) -> std::string;
+auto find_section(section_map const & section_db, section_tag const & tag) -> section_num const &;
+   // Return the section number for 'tag', or an empty section number if 'tag'
+   // is not in 'section_db'. Unlike 'section_map::operator[]' this never inserts,
+   // so once every tag has been added (see 'add_unknown_sections') the index
+   // can be shared by several threads.
+
+auto find_section_reference(section_map const & section_db, std::string const & doc_prefix, std::string_view name) -> section_tag;
+   // Return the tag that a reference to the section 'name' refers to, e.g.
+   // <sref ref="[name]"/> in an issue against the document 'doc_prefix'.
+   // If there is no such section in that document, but there is in the C++
+   // standard itself, the reference is assumed to be to the standard.
+
+auto format_section_tag_as_link(section_map const & section_db, section_tag const & tag) -> std::string;
+
+// The HTML for a link to each section in a section index, as made by
+// 'format_section_tag_as_link', so that it is made only once for each section.
+class section_link_map {
+public:
+   section_link_map() = default;
+   explicit section_link_map(section_map const & section_db);
+
+   auto find(section_tag const & tag) const -> std::string_view;
+     // Return the link to the section 'tag'.
+     // Throws 'runtime_error' if 'tag' was not in the section index.
+
+   auto find_reference(std::string_view doc_prefix, std::string_view name) const -> std::string_view;
+     // Return the link to the section that a reference to 'name' in a document
+     // 'doc_prefix' refers to, as determined by 'find_section_reference'.
+     // Throws 'runtime_error' if that section was not in the section index.
+
+private:
+   using key = std::pair<std::string_view, std::string_view>;   // prefix, name
+
+   struct key_less {
+      using is_transparent = void;
+      static auto as_key(section_tag const & t) noexcept -> key { return {t.prefix, t.name}; }
+      static auto as_key(key k) noexcept -> key { return k; }
+      auto operator()(auto const & x, auto const & y) const noexcept -> bool { return as_key(x) < as_key(y); }
+   };
+
+   auto find_key(key k) const -> std::string const *;
+
+   std::map<section_tag, std::string, key_less> m_links;
+};
 
 } // close namespace lwg
 
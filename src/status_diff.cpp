@@ -0,0 +1,359 @@
+//        Copyright the C++ Library Working Group
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// SPDX-License-Identifier: BSL-1.0
+
+#include "status_diff.h"
+
+#include "file_utils.h"
+#include "issues.h"
+#include "status.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// The first line of a status snapshot. The version must be incremented whenever the format changes.
+constexpr std::string_view status_snapshot_header = "LWG status snapshot 1";
+
+struct list_issues {
+   std::vector<int> const & issues;
+};
+
+
+auto operator<<( std::ostream & out, list_issues const & x) -> std::ostream & {
+   auto list_separator = "";
+   for (auto number : x.issues) {
+      out << list_separator << "<iref ref=\"" << number << "\"/>";
+      list_separator = ", ";
+   }
+   return out;
+}
+
+
+void print_new_issues(std::ostream & out, std::span<const lwg::issue_status> added) {
+   struct status_order {
+      // predicate for 'map'
+
+      using status_string = std::string;
+      auto operator()(status_string const & x, status_string const & y) const noexcept -> bool {
+         return lwg::get_status_priority(x) < lwg::get_status_priority(y);
+      }
+   };
+
+   std::map<std::string, std::vector<int>, status_order> added_issues;
+   for (auto const & [num, status] : added) {
+      added_issues[status].push_back(num);
+   }
+
+   for (auto const & i : added_issues) {
+      auto const item_count = std::get<1>(i).size();
+      if (1 == item_count) {
+         out << "<li>Added the following " << std::get<0>(i) << " issue: <iref ref=\"" << std::get<1>(i).front() << "\"/>.</li>\n";
+      }
+      else {
+         out << "<li>Added the following " << item_count << " " << std::get<0>(i) << " issues: " << list_issues{std::get<1>(i)} << ".</li>\n";
+      }
+   }
+
+   if (added_issues.empty()) {
+      out << "<li>No issues added.</li>\n";
+   }
+}
+
+
+void print_changed_issues(std::ostream & out, std::span<const lwg::status_transition> changed) {
+   struct status_transition_order {
+      using status_string = std::string;
+      using from_status_to_status = std::tuple<status_string, status_string>;
+
+      auto operator()(from_status_to_status const & x, from_status_to_status const & y) const noexcept -> bool {
+         auto const xp2 = lwg::get_status_priority(std::get<1>(x));
+         auto const yp2 = lwg::get_status_priority(std::get<1>(y));
+         return xp2 < yp2  or  (!(yp2 < xp2)  and  lwg::get_status_priority(std::get<0>(x)) < lwg::get_status_priority(std::get<0>(y)));
+      }
+   };
+
+   std::map<std::tuple<std::string, std::string>, std::vector<int>, status_transition_order> changed_issues;
+   for (auto const & t : changed) {
+      changed_issues[std::tuple<std::string, std::string>{t.from, t.to}].push_back(t.num);
+   }
+
+   for (auto const & i : changed_issues) {
+      auto const item_count = std::get<1>(i).size();
+      if (1 == item_count) {
+         out << "<li>Changed the following issue to " << std::get<1>(std::get<0>(i))
+             << " (from " << std::get<0>(std::get<0>(i)) << "): <iref ref=\"" << std::get<1>(i).front() << "\"/>.</li>\n";
+      }
+      else {
+         out << "<li>Changed the following " << item_count << " issues to " << std::get<1>(std::get<0>(i))
+             << " (from " << std::get<0>(std::get<0>(i)) << "): " << list_issues{std::get<1>(i)} << ".</li>\n";
+      }
+   }
+
+   if (changed_issues.empty()) {
+      out << "<li>No issues changed.</li>\n";
+   }
+}
+
+
+auto count_issues(std::span<const lwg::issue_status> issues) -> std::tuple<int, int, int> {
+   int n_open = 0;
+   int n_reassigned = 0;
+   int n_closed = 0;
+
+   for(auto const & elem : issues) {
+      if (lwg::is_assigned_to_another_group(std::get<1>(elem))) {
+      	++n_reassigned;
+      }
+      else if (lwg::is_active(std::get<1>(elem))) {
+         ++n_open;
+      }
+      else {
+         ++n_closed;
+      }
+   }
+   return {n_open, n_reassigned, n_closed};
+}
+
+
+void print_summary(std::ostream & out, std::span<const lwg::issue_status> old_issues, std::span<const lwg::issue_status> new_issues) {
+
+   auto [n_open_old, n_reassigned_old, n_closed_old] = count_issues(old_issues);
+   auto [n_open_new, n_reassigned_new, n_closed_new] = count_issues(new_issues);
+
+   auto write_change = [&out](int n_new, int n_old){
+      out << (n_new >= n_old ? "up by " : "down by ")
+          << std::abs(n_new - n_old);
+   };
+
+   out << "<li>" << n_open_new << " open issues, ";
+   write_change(n_open_new, n_open_old);
+   out << ".</li>\n";
+
+   out << "<li>" << n_closed_new << " closed issues, ";
+   write_change(n_closed_new, n_closed_old);
+   out << ".</li>\n";
+
+   out << "<li>" << n_reassigned_new << " reassigned issues, ";
+   write_change(n_reassigned_new, n_reassigned_old);
+   out << ".</li>\n";
+
+   int n_total_new = n_open_new + n_reassigned_new + n_closed_new;
+   int n_total_old = n_open_old + n_reassigned_old + n_closed_old;
+   out << "<li>" << n_total_new << " issues total, ";
+   write_change(n_total_new, n_total_old);
+   out << ".</li>\n";
+}
+
+
+// Write 's' as a JSON string.
+void print_json_string(std::ostream & out, std::string_view s) {
+   out << '"';
+   for (char c : s) {
+      if (c == '"' or c == '\\') {
+         out << '\\' << c;
+      }
+      else if (static_cast<unsigned char>(c) < 0x20) {
+         constexpr char hex[] = "0123456789abcdef";
+         out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+      }
+      else {
+         out << c;
+      }
+   }
+   out << '"';
+}
+
+} // close unnamed namespace
+
+
+auto lwg::read_issues_from_toc(std::string const & s) -> std::vector<issue_status> {
+   // The TOC file consists of a sequence of HTML <tr> elements - each element is one issue/row in the table
+   //    First we search the string for the first <tr> marker
+   //       The first row is the title row and does not contain an issue.
+   //       If we cannot find the first row, we flag an error and exit
+   //    Next we loop through the string, searching for <tr> markers to indicate the start of each issue
+   //       We parse the issue number and status from each row, and append a record to the result vector
+   //       If any parse fails, throw a runtime_error
+
+   // Skip the title row
+   auto i = s.find("<tr>");
+   if (std::string::npos == i) {
+      throw std::runtime_error{"Unable to find the first (title) row"};
+   }
+
+   auto extract_link_text = [&] (std::string desc) mutable {
+      i = s.find("</a>", i);
+      auto j = s.rfind('>', i);
+      if (j == std::string::npos) {
+         throw std::runtime_error{"unable to parse issue "+desc+": can't find beginning bracket"};
+      }
+      return s.substr(j+1, i-j-1);
+   };
+
+   // Read all issues in table
+   std::vector<issue_status> issues;
+   for(;;) {
+      i = s.find("<tr>", i+4);
+      if (i == std::string::npos) {
+         break;
+      }
+      int num = lwg::stoi(extract_link_text("number"));
+      i += 4;
+      std::string status = extract_link_text("status");
+      if (status == "(i)") {
+        i += 4;
+        status = extract_link_text("status");
+      }
+
+      issues.emplace_back(num, status);
+   }
+
+   return issues;
+}
+
+void lwg::write_status_snapshot(fs::path const & filename, std::span<const issue_status> issues) {
+   std::string s{status_snapshot_header};
+   s += '\n';
+   for (auto const & [num, status] : issues) {
+      s += std::to_string(num);
+      s += ' ';
+      s += status;
+      s += '\n';
+   }
+
+   if (fs::exists(filename) and lwg::read_file_into_string(filename) == s) {
+      return;
+   }
+   std::ofstream out{filename, std::ios::binary};
+   if (!(out << s)) {
+      throw std::runtime_error{"Failed to write " + filename.string()};
+   }
+}
+
+auto lwg::read_status_snapshot(std::string_view s) -> std::optional<std::vector<issue_status>> {
+   auto next_line = [&s] {
+      auto const eol = s.find('\n');
+      auto const line = s.substr(0, eol);
+      s.remove_prefix(eol == s.npos ? s.size() : eol + 1);
+      return line;
+   };
+
+   if (next_line() != status_snapshot_header) {
+      return std::nullopt;
+   }
+
+   std::vector<issue_status> issues;
+   while (!s.empty()) {
+      auto const line = next_line();
+      int num;
+      auto const [end, ec] = std::from_chars(line.data(), line.data() + line.size(), num);
+      if (ec != std::errc{} or end == line.data() + line.size() or *end != ' ') {
+         throw std::runtime_error{"Bad line in status snapshot: " + std::string(line)};
+      }
+      issues.emplace_back(num, line.substr(end + 1 - line.data()));
+   }
+   std::ranges::sort(issues);
+   return issues;
+}
+
+auto lwg::read_issue_statuses(fs::path const & filename) -> std::vector<issue_status> {
+   auto const contents = lwg::read_file_into_string(filename);
+   if (auto issues = read_status_snapshot(contents)) {
+      return *std::move(issues);
+   }
+   if (contents.starts_with(status_snapshot_header.substr(0, status_snapshot_header.rfind(' ') + 1))) {
+      throw std::runtime_error{filename.string() + " is a status snapshot in an unsupported format"};
+   }
+   auto issues = read_issues_from_toc(contents);
+   std::ranges::sort(issues);
+   return issues;
+}
+
+auto lwg::diff_issue_statuses(std::span<const issue_status> old_issues, std::span<const issue_status> new_issues) -> status_diff {
+   status_diff diff;
+   auto o = old_issues.begin();
+   auto n = new_issues.begin();
+   while (o != old_issues.end() or n != new_issues.end()) {
+      if (n == new_issues.end() or (o != old_issues.end() and std::get<0>(*o) < std::get<0>(*n))) {
+         diff.removed.push_back(*o++);
+      }
+      else if (o == old_issues.end() or std::get<0>(*n) < std::get<0>(*o)) {
+         diff.added.push_back(*n++);
+      }
+      else {
+         if (std::get<1>(*o) != std::get<1>(*n)) {
+            diff.changed.push_back({std::get<0>(*n), std::get<1>(*o), std::get<1>(*n)});
+         }
+         ++o;
+         ++n;
+      }
+   }
+   return diff;
+}
+
+void lwg::print_status_diff_html(std::ostream & out, std::span<const issue_status> old_issues, std::span<const issue_status> new_issues) {
+   auto const diff = diff_issue_statuses(old_issues, new_issues);
+   out << "<ul>\n"
+          "<li><b>Summary:</b><ul>\n";
+   print_summary(out, old_issues, new_issues);
+   out << "</ul></li>\n"
+          "<li><b>Details:</b><ul>\n";
+   print_new_issues(out, diff.added);
+   print_changed_issues(out, diff.changed);
+   out << "</ul></li>\n"
+          "</ul>\n";
+}
+
+void lwg::print_status_diff_text(std::ostream & out, status_diff const & diff) {
+   for (auto const & [num, status] : diff.added) {
+      out << "Added " << num << ": " << status << '\n';
+   }
+   for (auto const & [num, status] : diff.removed) {
+      out << "Removed " << num << ": " << status << '\n';
+   }
+   for (auto const & t : diff.changed) {
+      out << "Changed " << t.num << ": " << t.from << " -> " << t.to << '\n';
+   }
+}
+
+void lwg::print_status_diff_json(std::ostream & out, status_diff const & diff) {
+   auto print_issues = [&out](std::string_view name, std::span<const issue_status> issues) {
+      out << "  \"" << name << "\": [";
+      auto separator = "\n";
+      for (auto const & [num, status] : issues) {
+         out << separator << "    {\"num\": " << num << ", \"status\": ";
+         print_json_string(out, status);
+         out << '}';
+         separator = ",\n";
+      }
+      out << (issues.empty() ? "]" : "\n  ]");
+   };
+
+   out << "{\n";
+   print_issues("added", diff.added);
+   out << ",\n";
+   print_issues("removed", diff.removed);
+   out << ",\n  \"changed\": [";
+   auto separator = "\n";
+   for (auto const & t : diff.changed) {
+      out << separator << "    {\"num\": " << t.num << ", \"from\": ";
+      print_json_string(out, t.from);
+      out << ", \"to\": ";
+      print_json_string(out, t.to);
+      out << '}';
+      separator = ",\n";
+   }
+   out << (diff.changed.empty() ? "]" : "\n  ]") << "\n}\n";
+}
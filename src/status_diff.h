@@ -0,0 +1,74 @@
+#ifndef INCLUDE_LWG_STATUS_DIFF_H
+#define INCLUDE_LWG_STATUS_DIFF_H
+
+// standard headers
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace lwg
+{
+
+// The number and status of an issue in a revision of the lists, e.g. {1234, "Open"}.
+using issue_status = std::tuple<int, std::string>;
+
+auto read_issues_from_toc(std::string const & s) -> std::vector<issue_status>;
+   // Return the number and status of each issue in 's', the contents of the lwg-toc.html
+   // document of the current or a previous revision of the lists, in the order they
+   // appear, which is by issue number.
+   // Throws 'runtime_error' if *any* parse step fails.
+
+void write_status_snapshot(std::filesystem::path const & filename, std::span<const issue_status> issues);
+   // Write the number and status of each of the 'issues' to 'filename', one issue per line,
+   // so that the next revision of the lists can find what has changed since this one
+   // without scraping lwg-toc.html. The file is left alone if its contents would not change.
+   // Throws 'runtime_error' if the file cannot be written.
+
+auto read_status_snapshot(std::string_view s) -> std::optional<std::vector<issue_status>>;
+   // Parse 's', the contents of a file written by 'write_status_snapshot', and return the
+   // issues in it sorted by number. Return an empty optional if it was not written in the
+   // current format.
+   // Throws 'runtime_error' if it is not well-formed.
+
+auto read_issue_statuses(std::filesystem::path const & filename) -> std::vector<issue_status>;
+   // Read the issues in 'filename', which is either a status snapshot or an lwg-toc.html
+   // document, and return them sorted by number.
+   // Throws 'runtime_error' if the file cannot be read or parsed.
+
+// An issue that has a different status in two revisions of the lists.
+struct status_transition {
+   int         num;
+   std::string from;
+   std::string to;
+};
+
+// The differences between two revisions of the lists, each in order of issue number.
+struct status_diff {
+   std::vector<issue_status>      added;     // issues only in the new revision, with their status
+   std::vector<issue_status>      removed;   // issues only in the old revision, with their status
+   std::vector<status_transition> changed;   // issues whose status has changed
+};
+
+auto diff_issue_statuses(std::span<const issue_status> old_issues, std::span<const issue_status> new_issues) -> status_diff;
+   // Compare the issues in two revisions, which must both be sorted by issue number,
+   // in a single pass over each.
+
+void print_status_diff_html(std::ostream & out, std::span<const issue_status> old_issues, std::span<const issue_status> new_issues);
+   // Write a summary of the number of issues in each revision, and the issues that were
+   // added or changed, as the HTML list used in the revision history of the lists.
+   // <iref> elements are used to refer to issues.
+
+void print_status_diff_text(std::ostream & out, status_diff const & diff);
+   // Write one line for each issue that was added, removed or changed.
+
+void print_status_diff_json(std::ostream & out, status_diff const & diff);
+   // Write the differences as a JSON object with "added", "removed" and "changed" arrays.
+
+} // close namespace lwg
+
+#endif // INCLUDE_LWG_STATUS_DIFF_H
@@ -0,0 +1,72 @@
+//        Copyright the C++ Library Working Group
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// SPDX-License-Identifier: BSL-1.0
+
+// This program compares the status of the issues in two revisions of the issues lists,
+// and reports the issues that were added, removed or changed status between them.
+//
+// Usage: toc_diff [--format=text|json|html] OLD NEW
+//
+// OLD and NEW are either the lwg-toc.html documents of the two revisions, or the status
+// snapshots that bin/lists writes as mailing/lwg-toc.txt (and which are saved as
+// meta-data/lwg-toc.old.txt for the previous revision). Neither needs a build of the lists.
+//
+// The default "text" format writes one line per issue, "json" writes a JSON object, and
+// "html" writes the summary and details used in the revision history of lwg-issues.xml.
+
+// standard headers
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// solution specific headers
+#include "status_diff.h"
+
+int main(int argc, char const * argv[]) {
+   try {
+      std::string_view format = "text";
+      std::vector<std::string_view> files;
+      for (int i = 1; i < argc; ++i) {
+         std::string_view arg = argv[i];
+         if (arg.starts_with("--format=")) {
+            format = arg.substr(9);
+            if (format != "text" and format != "json" and format != "html") {
+               throw std::runtime_error{"Unknown format " + std::string(format)};
+            }
+         }
+         else if (arg.starts_with("-") and arg.size() > 1) {
+            throw std::runtime_error{"Unknown option " + std::string(arg)};
+         }
+         else {
+            files.push_back(arg);
+         }
+      }
+
+      if (files.size() != 2) {
+         std::cerr << "Usage: toc_diff [--format=text|json|html] OLD NEW\n";
+         return 2;
+      }
+
+      auto const old_issues = lwg::read_issue_statuses(files[0]);
+      auto const new_issues = lwg::read_issue_statuses(files[1]);
+
+      if (format == "html") {
+         lwg::print_status_diff_html(std::cout, old_issues, new_issues);
+      }
+      else if (format == "json") {
+         lwg::print_status_diff_json(std::cout, lwg::diff_issue_statuses(old_issues, new_issues));
+      }
+      else {
+         lwg::print_status_diff_text(std::cout, lwg::diff_issue_statuses(old_issues, new_issues));
+      }
+   }
+   catch(std::exception const & ex) {
+      std::cout << ex.what() << std::endl;
+      return -1;
+   }
+}